@@ -489,10 +489,20 @@ bool PulseSensorPlayground::setupInterrupt(){
     /*
         This will set up and start the timer interrupt on ESP32.
         The interrupt will occur every 2000uS or 500Hz.
+        The hw-timer API was reworked in arduino-esp32 core 3.x; support
+        both shapes so the backend builds on 2.x platforms (e.g. current
+        PlatformIO espressif32, esp32dev and esp32-s3 boards) and 3.x alike.
     */
-    sampleTimer = timerBegin(1000000); // 1MHz ticker, 1uS tick period                
-    timerAttachInterrupt(sampleTimer, &onInterrupt);  
-    timerAlarm(sampleTimer, 2000, true, 0);    
+    #if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    sampleTimer = timerBegin(1000000); // 1MHz ticker, 1uS tick period
+    timerAttachInterrupt(sampleTimer, &onInterrupt);
+    timerAlarm(sampleTimer, 2000, true, 0);
+    #else
+    sampleTimer = timerBegin(0, getApbFrequency() / 1000000, true); // 1uS tick
+    timerAttachInterrupt(sampleTimer, &onInterrupt, true);
+    timerAlarmWrite(sampleTimer, 2000, true);
+    timerAlarmEnable(sampleTimer);
+    #endif
     result = true;
   #endif
 
@@ -562,7 +572,11 @@ bool PulseSensorPlayground::enableInterrupt(){
     #endif
 
   #if defined(ARDUINO_ARCH_ESP32)
+    #if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
     timerStart(sampleTimer);
+    #else
+    timerAlarmEnable(sampleTimer);
+    #endif
     result = true;
   #endif
 
@@ -645,7 +659,12 @@ bool PulseSensorPlayground::disableInterrupt(){
     #endif
 
   #if defined(ARDUINO_ARCH_ESP32)
+    #if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
     timerStop(sampleTimer);
+    #else
+    timerAlarmDisable(sampleTimer);
+    #endif
+    result = true;
   #endif
 
   #if defined(ARDUINO_ARCH_NRF52840)
@@ -76,6 +76,14 @@
 #if defined ARDUINO_ARCH_AVR
 #define DISABLE_PULSE_SENSOR_INTERRUPTS cli()
 #define ENABLE_PULSE_SENSOR_INTERRUPTS sei()
+#elif defined(ARDUINO_ARCH_ESP32)
+// On ESP32 the timer ISR can fire on either core, so sketch-side reads of
+// the sample variables need a critical section, not an empty macro. The
+// spinlock itself is defined in TimerHandler.h alongside the timer; the
+// ISR takes the _ISR flavor of the same lock.
+extern portMUX_TYPE timerMux;
+#define DISABLE_PULSE_SENSOR_INTERRUPTS portENTER_CRITICAL(&timerMux)
+#define ENABLE_PULSE_SENSOR_INTERRUPTS portEXIT_CRITICAL(&timerMux)
 #else
 #define DISABLE_PULSE_SENSOR_INTERRUPTS
 #define ENABLE_PULSE_SENSOR_INTERRUPTS
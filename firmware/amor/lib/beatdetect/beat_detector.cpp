@@ -0,0 +1,112 @@
+#include "beat_detector.h"
+
+// Seeds for the 12-bit input range (the reference uses 512/100 on 10 bits)
+#define SEED_MIDPOINT 2048
+#define SEED_AMPLITUDE 400
+
+BeatDetector::BeatDetector(int sampleIntervalMs, int threshold)
+    : sampleIntervalMs(sampleIntervalMs), threshSetting(threshold) {
+  reset();
+}
+
+void BeatDetector::reset() {
+  for (int i = 0; i < 10; i++) {
+    rate[i] = 0;
+  }
+  bpm = 0;
+  ibi = 750;                  // 750ms per beat = 80 BPM seed
+  pulse = false;
+  amp = SEED_AMPLITUDE;
+  lastBeatTime = 0;
+  sampleCounter = 0;
+  P = SEED_MIDPOINT;
+  T = SEED_MIDPOINT;
+  thresh = threshSetting;
+  firstBeat = true;
+  secondBeat = false;
+}
+
+void BeatDetector::setThreshold(int threshold) {
+  threshSetting = threshold;
+  thresh = threshold;
+}
+
+bool BeatDetector::processSample(int value) {
+  bool sawBeat = false;
+
+  sampleCounter += sampleIntervalMs;
+  int N = sampleCounter - lastBeatTime;   // ms since the last beat
+
+  // Track the trough; wait 3/5 of the last IBI to avoid dichrotic noise
+  if (value < thresh && N > (ibi / 5) * 3) {
+    if (value < T) {
+      T = value;
+    }
+  }
+
+  // Track the peak
+  if (value > thresh && value > P) {
+    P = value;
+  }
+
+  // Look for the beat: the signal surges up across thresh on every pulse
+  if (N > 250) {                          // avoid high-frequency noise
+    if ((value > thresh) && (pulse == false) && (N > (ibi / 5) * 3)) {
+      pulse = true;
+      ibi = sampleCounter - lastBeatTime;
+      lastBeatTime = sampleCounter;
+
+      if (secondBeat) {
+        // Seed the running average so startup BPM is realistic
+        secondBeat = false;
+        for (int i = 0; i < 10; i++) {
+          rate[i] = ibi;
+        }
+      }
+
+      if (firstBeat) {
+        // First IBI is measured against reset time and is unreliable
+        firstBeat = false;
+        secondBeat = true;
+        return false;
+      }
+
+      // Average the last ten IBIs for BPM
+      unsigned int runningTotal = 0;
+      for (int i = 0; i < 9; i++) {
+        rate[i] = rate[i + 1];
+        runningTotal += rate[i];
+      }
+      rate[9] = ibi;
+      runningTotal += rate[9];
+      runningTotal /= 10;
+      bpm = 60000 / runningTotal;
+      sawBeat = true;
+    }
+  }
+
+  // Falling below thresh ends the beat; recenter thresh on the amplitude
+  if (value < thresh && pulse == true) {
+    pulse = false;
+    amp = P - T;
+    thresh = amp / 2 + T;
+    P = thresh;
+    T = thresh;
+  }
+
+  // 2.5s without a beat: return to seeds and wait for the signal to return
+  if (N > 2500) {
+    thresh = threshSetting;
+    P = SEED_MIDPOINT;
+    T = SEED_MIDPOINT;
+    lastBeatTime = sampleCounter;
+    firstBeat = true;
+    secondBeat = false;
+    bpm = 0;
+    ibi = 600;                // 600ms per beat = 100 BPM seed
+    pulse = false;
+    amp = SEED_AMPLITUDE;
+  }
+
+  return sawBeat;
+}
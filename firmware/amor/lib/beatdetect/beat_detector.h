@@ -0,0 +1,70 @@
+/*
+ * Amor ESP32 Firmware - On-device PPG beat detector
+ *
+ * Port of the integer P/T/thresh/IBI state machine from the PulseSensor
+ * Playground reference (PulseSensor::processLatestSample), adapted for our
+ * 12-bit ADC range and stripped of the Arduino/LED plumbing. The algorithm
+ * is unchanged: track peak and trough around an adaptive threshold, call a
+ * beat on an upward crossing after 3/5 of the last IBI, average the last
+ * ten IBIs for BPM, and reset to seeds after 2.5s without a beat.
+ *
+ * No Arduino or ESP-IDF dependencies: the same code runs on-device and in
+ * the host-side tooling.
+ *
+ * Original algorithm: Copyright World Famous Electronics LLC, MIT license
+ * (Joel Murphy, Yury Gitman, Bradford Needham). Not intended for medical use.
+ */
+
+#ifndef BEAT_DETECTOR_H
+#define BEAT_DETECTOR_H
+
+// Default adaptive-threshold seed for 12-bit samples (the reference uses
+// 550 on its 10-bit range; this is the same fraction of full scale).
+#define BEAT_DETECTOR_DEFAULT_THRESHOLD 2200
+
+class BeatDetector {
+  public:
+    // sampleIntervalMs is the spacing of samples fed to processSample().
+    BeatDetector(int sampleIntervalMs = 20,
+                 int threshold = BEAT_DETECTOR_DEFAULT_THRESHOLD);
+
+    // Reset all detection state to seeds (e.g. after a sampling gap).
+    void reset();
+
+    // Update the threshold seed used after resets.
+    void setThreshold(int threshold);
+
+    // Process one 12-bit sample (0-4095). Returns true when this sample
+    // starts a new beat with a valid IBI (startup beats are suppressed).
+    bool processSample(int value);
+
+    // Latest measurements; valid after processSample() returns true.
+    int getBeatsPerMinute() const { return bpm; }
+    int getInterBeatIntervalMs() const { return ibi; }
+    int getPulseAmplitude() const { return amp; }
+    bool isInsideBeat() const { return pulse; }
+
+    // Detector-internal time (ms since reset) of the last detected beat.
+    unsigned long getLastBeatTime() const { return lastBeatTime; }
+
+  private:
+    // Configuration
+    int sampleIntervalMs;       // Expected ms between processSample() calls
+    int threshSetting;          // Threshold seed restored on reset
+
+    // Detection state (names follow the reference implementation)
+    int bpm;
+    int ibi;                    // Inter-beat interval (ms)
+    bool pulse;                 // Inside a beat right now
+    int amp;                    // Amplitude of the last full pulse wave
+    unsigned long lastBeatTime; // sampleCounter at the last beat
+    unsigned long sampleCounter;// ms since reset, advanced per sample
+    int rate[10];               // Last ten IBIs for the BPM average
+    int P;                      // Running peak
+    int T;                      // Running trough
+    int thresh;                 // Adaptive threshold
+    bool firstBeat;
+    bool secondBeat;
+};
+
+#endif // BEAT_DETECTOR_H
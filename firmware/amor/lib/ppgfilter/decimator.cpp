@@ -0,0 +1,46 @@
+#include <string.h>
+#include "decimator.h"
+
+// 31-tap Hamming-windowed sinc lowpass, 20Hz cutoff at 500Hz input rate,
+// Q15 with coefficients summing to exactly 32768 (unity DC gain).
+static const int16_t kTaps[DECIMATOR_TAPS] = {
+     -36,    -27,    -13,     20,     88,    207,    387,    632,
+     937,   1288,   1662,   2031,   2362,   2625,   2794,   2854,
+    2794,   2625,   2362,   2031,   1662,   1288,    937,    632,
+     387,    207,     88,     20,    -13,    -27,    -36,
+};
+
+Decimator::Decimator(int factor) : factor(factor) {
+  reset();
+}
+
+void Decimator::reset() {
+  phase = 0;
+  historyPos = 0;
+  memset(history, 0, sizeof(history));
+}
+
+bool Decimator::processSample(uint16_t value, uint16_t* out) {
+  history[historyPos] = value;
+  historyPos = (historyPos + 1) % DECIMATOR_TAPS;
+
+  if (++phase < factor) {
+    return false;
+  }
+  phase = 0;
+
+  // Convolve only when an output is due: newest sample gets tap 0
+  int32_t acc = 0;
+  int pos = historyPos;
+  for (int i = 0; i < DECIMATOR_TAPS; i++) {
+    pos = (pos == 0) ? DECIMATOR_TAPS - 1 : pos - 1;
+    acc += (int32_t)history[pos] * kTaps[i];
+  }
+
+  // Back to 12-bit range with rounding; negative ringing clamps to 0
+  acc = (acc + (1 << 14)) >> 15;
+  if (acc < 0) acc = 0;
+  if (acc > 4095) acc = 4095;
+  *out = (uint16_t)acc;
+  return true;
+}
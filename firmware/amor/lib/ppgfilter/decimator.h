@@ -0,0 +1,45 @@
+/*
+ * Amor ESP32 Firmware - FIR decimator for oversampled PPG capture
+ *
+ * Capturing at 50Hz directly gives marginal pulse-waveform fidelity (the
+ * PulseSensor reference samples at 500Hz for a reason). The oversampling
+ * path captures at OVERSAMPLE_RATE_HZ and this decimator filters the raw
+ * stream through an anti-aliasing FIR lowpass before taking every Nth
+ * output, so the 50Hz wire rate carries anti-aliased, higher-SNR samples
+ * at unchanged bandwidth.
+ *
+ * The filter is a 31-tap Hamming-windowed sinc, 20Hz cutoff at 500Hz input
+ * rate, in Q15 fixed point with exact unity DC gain (coefficients sum to
+ * 32768). The multiply-accumulate only runs for samples that survive
+ * decimation, so cost is ~31 MACs per 50Hz output, not per 500Hz input.
+ *
+ * No Arduino or ESP-IDF dependencies: also compiled by the host tooling.
+ */
+
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+
+#define DECIMATOR_TAPS 31
+
+class Decimator {
+  public:
+    // factor = input rate / output rate (e.g. 500Hz / 50Hz = 10).
+    explicit Decimator(int factor);
+
+    // Clear filter history (e.g. after a capture restart).
+    void reset();
+
+    // Feed one raw sample. Returns true when an output sample is due and
+    // stores the filtered, decimated value in *out.
+    bool processSample(uint16_t value, uint16_t* out);
+
+  private:
+    int factor;
+    int phase;                        // Inputs consumed since last output
+    int historyPos;                   // Circular write index
+    uint16_t history[DECIMATOR_TAPS]; // Raw sample delay line
+};
+
+#endif // DECIMATOR_H
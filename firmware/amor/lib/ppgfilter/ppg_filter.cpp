@@ -0,0 +1,63 @@
+#include <math.h>
+#include "ppg_filter.h"
+
+// Pulse band: drift/offset below, broadband noise above.
+#define PPG_FILTER_HIGHPASS_HZ 0.5f
+#define PPG_FILTER_LOWPASS_HZ 8.0f
+
+// Mid-scale re-centering for the conditioned (zero-mean) signal.
+#define PPG_FILTER_CENTER 2048
+
+PpgFilter::PpgFilter(int sampleRateHz) {
+  // Float math here only: construction and rate changes, never per sample.
+  float fs = (float)sampleRateHz;
+
+  // DC blocker pole: corner ~= fs * (1 - pole) / 2*pi
+  float pole = 1.0f - (2.0f * (float)M_PI * PPG_FILTER_HIGHPASS_HZ) / fs;
+  dcPole = (int32_t)lroundf(pole * 32768.0f);
+
+  // Butterworth low-pass biquad (RBJ cookbook), normalized by a0
+  float w0 = 2.0f * (float)M_PI * PPG_FILTER_LOWPASS_HZ / fs;
+  float alpha = sinf(w0) / (2.0f * 0.70710678f);  // Q = 1/sqrt(2)
+  float a0 = 1.0f + alpha;
+  b0 = (int32_t)lroundf(((1.0f - cosf(w0)) / 2.0f) / a0 * 16384.0f);
+  b1 = (int32_t)lroundf((1.0f - cosf(w0)) / a0 * 16384.0f);
+  b2 = b0;
+  a1 = (int32_t)lroundf((-2.0f * cosf(w0)) / a0 * 16384.0f);
+  a2 = (int32_t)lroundf((1.0f - alpha) / a0 * 16384.0f);
+
+  reset();
+}
+
+void PpgFilter::reset() {
+  dcPrevIn = 0;
+  dcPrevOut = 0;
+  x1 = x2 = 0;
+  y1 = y2 = 0;
+}
+
+uint16_t PpgFilter::processSample(uint16_t value) {
+  int32_t x = value & 0x0FFF;
+
+  // DC removal. hp stays within +/-4096 once settled, so the Q15 product
+  // fits comfortably in 32 bits.
+  int32_t hp = x - dcPrevIn + ((dcPole * dcPrevOut) >> 15);
+  dcPrevIn = x;
+  dcPrevOut = hp;
+
+  // Pulse-band low-pass. 64-bit accumulator: five Q14 products of
+  // 13-bit-ish values can brush the int32 edge during transients.
+  int64_t acc = (int64_t)b0 * hp + (int64_t)b1 * x1 + (int64_t)b2 * x2 -
+                (int64_t)a1 * y1 - (int64_t)a2 * y2;
+  int32_t y = (int32_t)((acc + (1 << 13)) >> 14);
+  x2 = x1;
+  x1 = hp;
+  y2 = y1;
+  y1 = y;
+
+  // Back to the 12-bit wire range, centered at mid-scale
+  int32_t out = PPG_FILTER_CENTER + y;
+  if (out < 0) out = 0;
+  if (out > 4095) out = 4095;
+  return (uint16_t)out;
+}
@@ -0,0 +1,60 @@
+/*
+ * Amor ESP32 Firmware - Fixed-point PPG conditioning filter
+ *
+ * Raw ADC samples carry a large DC offset (sensor bias sits near mid-scale)
+ * plus baseline drift, so most of the 12-bit range is spent on a constant
+ * and the server has to remove it per channel. This stage conditions each
+ * sample on-device, between sampling and bundling:
+ *
+ *   1. First-order DC blocker (high-pass, ~0.5Hz corner) removes offset
+ *      and drift.
+ *   2. Second-order Butterworth low-pass (~8Hz corner) keeps the pulse
+ *      band and its useful harmonics while cutting broadband noise.
+ *
+ * Together they form a 0.5-8Hz pulse bandpass. The output is re-centered
+ * at mid-scale (2048) and clamped to 12 bits, so the wire format, the
+ * beat detector's thresholds, and the packed-blob codec all work
+ * unchanged — and the small, centered deltas compress markedly better.
+ *
+ * All hot-path arithmetic is integer: the DC blocker pole is Q15, the
+ * biquad coefficients Q14 (their magnitudes exceed 1). Coefficients are
+ * computed once at construction from the sample rate using float math,
+ * never per sample. A biquad is a serial recurrence (each output feeds
+ * the next), so there is nothing for SIMD to vectorize here; the whole
+ * stage is ~7 multiplies per sample.
+ *
+ * No Arduino or ESP-IDF dependencies: also compiled by the host tooling.
+ */
+
+#ifndef PPG_FILTER_H
+#define PPG_FILTER_H
+
+#include <stdint.h>
+
+class PpgFilter {
+  public:
+    // Corners are fixed (0.5-8Hz pulse band); coefficients adapt to the
+    // sample rate. Matches the BeatDetector construction pattern.
+    explicit PpgFilter(int sampleRateHz = 50);
+
+    // Clear filter history (e.g. after a rate change).
+    void reset();
+
+    // Condition one raw 12-bit sample. Returns the filtered sample,
+    // centered at 2048 and clamped to 0-4095.
+    uint16_t processSample(uint16_t value);
+
+  private:
+    // DC blocker: y[n] = x[n] - x[n-1] + pole * y[n-1]
+    int32_t dcPole;       // Q15
+    int32_t dcPrevIn;
+    int32_t dcPrevOut;
+
+    // Low-pass biquad, Q14 coefficients (normalized by a0)
+    int32_t b0, b1, b2;
+    int32_t a1, a2;
+    int32_t x1, x2;       // Input history
+    int32_t y1, y2;       // Output history
+};
+
+#endif // PPG_FILTER_H
@@ -0,0 +1,163 @@
+#include <string.h>
+#include "spool_codec.h"
+
+// Delta reference at the start of every block: ADC mid-scale.
+#define SPOOL_CODEC_SEED 2048
+
+// Worst case for one record: count and channel bytes + timestamp + escape
+// on every sample (6 + 12 bits each). Used for the conservative fit check.
+#define SPOOL_CODEC_MAX_RECORD_BITS(count) (8 + 8 + 32 + (count) * (6 + 12))
+
+// ============================================================================
+// Bit-level helpers (MSB-first, matching the wire format's packing)
+// ============================================================================
+
+static void putBits(uint8_t* buf, size_t* posBits, uint32_t value, int bits) {
+  for (int i = bits - 1; i >= 0; i--) {
+    size_t byte = *posBits >> 3;
+    int shift = 7 - (int)(*posBits & 7);
+    if ((*posBits & 7) == 0) {
+      buf[byte] = 0;
+    }
+    buf[byte] |= (uint8_t)(((value >> i) & 1) << shift);
+    (*posBits)++;
+  }
+}
+
+static uint32_t getBits(const uint8_t* buf, size_t* posBits, int bits) {
+  uint32_t value = 0;
+  for (int i = 0; i < bits; i++) {
+    size_t byte = *posBits >> 3;
+    int shift = 7 - (int)(*posBits & 7);
+    value = (value << 1) | ((buf[byte] >> shift) & 1);
+    (*posBits)++;
+  }
+  return value;
+}
+
+// Zigzag: small signed deltas to small unsigned codes (-1 -> 1, 1 -> 2 ...)
+static uint32_t zigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+void spoolCodecWriterInit(SpoolBlockWriter* w, uint8_t* buf, size_t cap) {
+  w->buf = buf;
+  w->capBits = cap * 8;
+  w->posBits = SPOOL_CODEC_HEADER_SIZE * 8;
+  w->records = 0;
+  w->prevSample = SPOOL_CODEC_SEED;
+}
+
+bool spoolCodecWrite(SpoolBlockWriter* w, const uint16_t* samples, int count,
+                     uint8_t channel, uint32_t timestampMs) {
+  if (count < 1 || count > 255) {
+    return false;
+  }
+  if (w->posBits + SPOOL_CODEC_MAX_RECORD_BITS(count) > w->capBits) {
+    return false;  // might not fit; caller commits the block and retries
+  }
+
+  putBits(w->buf, &w->posBits, (uint32_t)count, 8);
+  putBits(w->buf, &w->posBits, channel, 8);
+  putBits(w->buf, &w->posBits, timestampMs, 32);
+
+  for (int i = 0; i < count; i++) {
+    uint16_t v = samples[i] & 0x0FFF;
+    int32_t delta = (int32_t)v - (int32_t)w->prevSample;
+    uint32_t code = zigzag(delta);
+    if (code < SPOOL_CODEC_ESCAPE) {
+      putBits(w->buf, &w->posBits, code, 6);
+    } else {
+      putBits(w->buf, &w->posBits, SPOOL_CODEC_ESCAPE, 6);
+      putBits(w->buf, &w->posBits, v, 12);
+    }
+    w->prevSample = v;
+  }
+
+  w->records++;
+  return true;
+}
+
+size_t spoolCodecFinish(SpoolBlockWriter* w) {
+  if (w->records == 0) {
+    return 0;
+  }
+  w->buf[0] = (uint8_t)(SPOOL_CODEC_MAGIC & 0xFF);
+  w->buf[1] = (uint8_t)(SPOOL_CODEC_MAGIC >> 8);
+  w->buf[2] = (uint8_t)(w->records & 0xFF);
+  w->buf[3] = (uint8_t)(w->records >> 8);
+  return (w->posBits + 7) >> 3;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+int spoolCodecPeekCount(const uint8_t* buf, size_t len) {
+  if (len < SPOOL_CODEC_HEADER_SIZE ||
+      (buf[0] | (buf[1] << 8)) != SPOOL_CODEC_MAGIC) {
+    return -1;
+  }
+  return buf[2] | (buf[3] << 8);
+}
+
+bool spoolCodecReaderInit(SpoolBlockReader* r, const uint8_t* buf,
+                          size_t len) {
+  int count = spoolCodecPeekCount(buf, len);
+  if (count <= 0) {
+    return false;
+  }
+  r->buf = buf;
+  r->lenBits = len * 8;
+  r->posBits = SPOOL_CODEC_HEADER_SIZE * 8;
+  r->remaining = (uint16_t)count;
+  r->prevSample = SPOOL_CODEC_SEED;
+  return true;
+}
+
+bool spoolCodecRead(SpoolBlockReader* r, uint16_t* samples, int maxSamples,
+                    int* count, uint8_t* channel, uint32_t* timestampMs) {
+  if (r->remaining == 0 || r->posBits + 8 + 8 + 32 > r->lenBits) {
+    return false;
+  }
+
+  int n = (int)getBits(r->buf, &r->posBits, 8);
+  *channel = (uint8_t)getBits(r->buf, &r->posBits, 8);
+  *timestampMs = getBits(r->buf, &r->posBits, 32);
+  if (n < 1 || n > maxSamples) {
+    r->remaining = 0;  // malformed; abandon the rest of the block
+    return false;
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (r->posBits + 6 > r->lenBits) {
+      r->remaining = 0;
+      return false;
+    }
+    uint32_t code = getBits(r->buf, &r->posBits, 6);
+    uint16_t v;
+    if (code == SPOOL_CODEC_ESCAPE) {
+      if (r->posBits + 12 > r->lenBits) {
+        r->remaining = 0;
+        return false;
+      }
+      v = (uint16_t)getBits(r->buf, &r->posBits, 12);
+    } else {
+      v = (uint16_t)((int32_t)r->prevSample + unzigzag(code));
+    }
+    samples[i] = v;
+    r->prevSample = v;
+  }
+
+  *count = n;
+  r->remaining--;
+  return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * Amor ESP32 Firmware - Spool block codec
+ *
+ * Encodes sealed bundles into fixed-size storage blocks for the outage
+ * spool (src/spool.cpp). PPG is a slowly-moving signal, so consecutive
+ * samples differ by a handful of counts; each sample is stored as a
+ * zigzag-coded 6-bit delta against the previous one, with an escape to a
+ * 12-bit absolute value for the rare large jump. Timestamps stay absolute
+ * (4 bytes per bundle) so a corrupted record can't skew everything after it.
+ *
+ * Block layout (little-endian, fits one 4KB flash erase block):
+ *   uint16  magic        (SPOOL_CODEC_MAGIC)
+ *   uint16  recordCount
+ *   records, bit-packed MSB-first:
+ *     uint8   sampleCount
+ *     uint8   channel
+ *     uint32  timestampMs
+ *     6-bit zigzag deltas (63 = escape + 12-bit absolute); the previous
+ *     sample value carries across records within the block and seeds at
+ *     mid-scale (2048) per block
+ *
+ * No Arduino or ESP-IDF dependencies: the codec is exercised by the
+ * host-side tooling as well as the firmware.
+ */
+
+#ifndef SPOOL_CODEC_H
+#define SPOOL_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SPOOL_CODEC_MAGIC 0x5053          // "SP"
+#define SPOOL_CODEC_HEADER_SIZE 4
+#define SPOOL_CODEC_ESCAPE 63             // 6-bit escape to a 12-bit absolute
+
+// Incremental writer over a caller-owned block buffer.
+struct SpoolBlockWriter {
+  uint8_t* buf;
+  size_t capBits;       // Buffer capacity in bits
+  size_t posBits;       // Write position in bits (after the header)
+  uint16_t records;
+  uint16_t prevSample;  // Delta reference, carried across records
+};
+
+// Incremental reader over an encoded block.
+struct SpoolBlockReader {
+  const uint8_t* buf;
+  size_t lenBits;
+  size_t posBits;
+  uint16_t remaining;   // Records left to read
+  uint16_t prevSample;
+};
+
+// Start a fresh block in buf (capacity cap bytes, must exceed the header).
+void spoolCodecWriterInit(SpoolBlockWriter* w, uint8_t* buf, size_t cap);
+
+// Append one bundle. Returns false (leaving the block untouched) when the
+// record might not fit; the caller then commits the block and retries.
+bool spoolCodecWrite(SpoolBlockWriter* w, const uint16_t* samples, int count,
+                     uint8_t channel, uint32_t timestampMs);
+
+// Patch the header and return the encoded size in bytes (0 if empty).
+size_t spoolCodecFinish(SpoolBlockWriter* w);
+
+// Records currently encoded in the writer's block.
+static inline int spoolCodecWriterCount(const SpoolBlockWriter* w) {
+  return w->records;
+}
+
+// Attach a reader to an encoded block. Returns false on a bad header.
+bool spoolCodecReaderInit(SpoolBlockReader* r, const uint8_t* buf, size_t len);
+
+// Record count of an encoded block without decoding it (header peek).
+int spoolCodecPeekCount(const uint8_t* buf, size_t len);
+
+// Decode the next record. Returns false when the block is exhausted or the
+// record is malformed; *count receives the sample count (up to maxSamples).
+bool spoolCodecRead(SpoolBlockReader* r, uint16_t* samples, int maxSamples,
+                    int* count, uint8_t* channel, uint32_t* timestampMs);
+
+#endif // SPOOL_CODEC_H
@@ -0,0 +1,110 @@
+#include "stream_stats.h"
+
+#define DEQUE_NEXT(i) (((i) + 1) % STREAM_STATS_MAX_WINDOW)
+#define DEQUE_PREV(i) (((i) + STREAM_STATS_MAX_WINDOW - 1) % STREAM_STATS_MAX_WINDOW)
+
+// Integer square root, round-to-nearest; no float math on the stats path.
+static uint16_t isqrt32(uint32_t x) {
+  uint32_t r = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (x >= r + bit) {
+      x -= r + bit;
+      r = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)r;
+}
+
+StreamStats::StreamStats(int window) {
+  reset(window);
+}
+
+void StreamStats::reset(int newWindow) {
+  if (newWindow < 1) {
+    newWindow = 1;
+  }
+  if (newWindow > STREAM_STATS_MAX_WINDOW) {
+    newWindow = STREAM_STATS_MAX_WINDOW;
+  }
+  window = newWindow;
+  filled = 0;
+  seq = 0;
+  sum = 0;
+  sumSq = 0;
+  minHead = minTail = 0;
+  maxHead = maxTail = 0;
+}
+
+void StreamStats::addSample(uint16_t value) {
+  // Sliding sums: subtract the sample falling out of the window
+  if (filled == window) {
+    uint16_t old = ring[seq % window];
+    sum -= old;
+    sumSq -= (uint64_t)old * old;
+  } else {
+    filled++;
+  }
+  ring[seq % window] = value;
+  sum += value;
+  sumSq += (uint64_t)value * value;
+
+  // Min deque: drop entries that can never be the minimum again
+  while (minTail != minHead && minVal[DEQUE_PREV(minTail)] >= value) {
+    minTail = DEQUE_PREV(minTail);
+  }
+  minVal[minTail] = value;
+  minSeq[minTail] = seq;
+  minTail = DEQUE_NEXT(minTail);
+
+  // Max deque, mirrored
+  while (maxTail != maxHead && maxVal[DEQUE_PREV(maxTail)] <= value) {
+    maxTail = DEQUE_PREV(maxTail);
+  }
+  maxVal[maxTail] = value;
+  maxSeq[maxTail] = seq;
+  maxTail = DEQUE_NEXT(maxTail);
+
+  seq++;
+
+  // Expire fronts that slid out of the window
+  uint32_t expired = seq - filled;  // oldest in-window seq is this value
+  while (minHead != minTail && minSeq[minHead] < expired) {
+    minHead = DEQUE_NEXT(minHead);
+  }
+  while (maxHead != maxTail && maxSeq[maxHead] < expired) {
+    maxHead = DEQUE_NEXT(maxHead);
+  }
+}
+
+uint16_t StreamStats::minimum() const {
+  return (minHead != minTail) ? minVal[minHead] : 0;
+}
+
+uint16_t StreamStats::maximum() const {
+  return (maxHead != maxTail) ? maxVal[maxHead] : 0;
+}
+
+uint16_t StreamStats::mean() const {
+  return (filled > 0) ? (uint16_t)(sum / filled) : 0;
+}
+
+uint32_t StreamStats::variance() const {
+  if (filled == 0) {
+    return 0;
+  }
+  // Exact: (n*sumSq - sum^2) / n^2, all in 64-bit
+  uint64_t n = (uint64_t)filled;
+  uint64_t num = n * sumSq - (uint64_t)sum * sum;
+  return (uint32_t)(num / (n * n));
+}
+
+uint16_t StreamStats::stddev() const {
+  return isqrt32(variance());
+}
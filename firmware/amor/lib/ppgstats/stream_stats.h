@@ -0,0 +1,78 @@
+/*
+ * Amor ESP32 Firmware - Incremental sliding-window sample statistics
+ *
+ * printStats() used to walk the 50-sample ADC ring twice every 5 seconds
+ * (sum/min/max, then a float sqrt stddev pass) on the task that must hit
+ * the sample grid. This engine maintains the same statistics incrementally,
+ * O(1) per sample with no array scan at read time:
+ *
+ *   - mean/variance from exact integer running sums over the window
+ *     (12-bit samples fit sum in 32 bits and sum-of-squares in 64, so the
+ *     sliding add/subtract is lossless — no need for Welford's float
+ *     recurrence, which exists to tame rounding that integers don't have)
+ *   - min/max from monotonic deques, amortized O(1) per sample
+ *
+ * The window length is configurable per instance up to
+ * STREAM_STATS_MAX_WINDOW (e.g. one instance each for 1s/10s windows);
+ * variance is always current, which the signal-quality logic reads
+ * per-sample, not just at the 5s print.
+ *
+ * No Arduino or ESP-IDF dependencies; shared with the host-side tooling.
+ */
+
+#ifndef STREAM_STATS_H
+#define STREAM_STATS_H
+
+#include <stdint.h>
+
+// Largest supported window in samples. 256 is ~5s at the 50Hz wire rate;
+// raise it (more RAM: ~8 bytes/sample) for longer windows.
+#ifndef STREAM_STATS_MAX_WINDOW
+#define STREAM_STATS_MAX_WINDOW 256
+#endif
+
+class StreamStats {
+  public:
+    // window is clamped to 1..STREAM_STATS_MAX_WINDOW.
+    explicit StreamStats(int window = STREAM_STATS_MAX_WINDOW);
+
+    // Drop all state and change the window length.
+    void reset(int window);
+
+    // Account one 12-bit sample; O(1) amortized.
+    void addSample(uint16_t value);
+
+    // Samples currently in the window (caps at the window length).
+    int count() const { return filled; }
+
+    // All results are integer and exact over the current window.
+    // mean/variance/stddev require count() > 0; min/max likewise.
+    uint16_t minimum() const;
+    uint16_t maximum() const;
+    uint16_t mean() const;
+    uint32_t variance() const;
+    uint16_t stddev() const;
+
+  private:
+    int window;
+    int filled;
+    uint32_t seq;                  // Total samples ever added
+
+    // Sample ring: needed to subtract the outgoing sample from the sums
+    uint16_t ring[STREAM_STATS_MAX_WINDOW];
+
+    uint32_t sum;
+    uint64_t sumSq;
+
+    // Monotonic deques (circular): minDeque ascending, maxDeque descending.
+    // seq tags let the front expire when it leaves the window.
+    uint16_t minVal[STREAM_STATS_MAX_WINDOW];
+    uint32_t minSeq[STREAM_STATS_MAX_WINDOW];
+    int minHead, minTail;          // [head, tail) in circular indexing
+
+    uint16_t maxVal[STREAM_STATS_MAX_WINDOW];
+    uint32_t maxSeq[STREAM_STATS_MAX_WINDOW];
+    int maxHead, maxTail;
+};
+
+#endif // STREAM_STATS_H
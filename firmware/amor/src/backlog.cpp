@@ -0,0 +1,62 @@
+#include <string.h>
+#include "backlog.h"
+#include "spool.h"
+#include "telemetry_log.h"
+
+// Only the network task touches the backlog, so no locking is needed.
+static BundleRecord ring[BACKLOG_BUNDLES];
+static int head = 0;       // Next slot to write
+static int tail = 0;       // Oldest unsent record
+static int count = 0;
+static uint32_t droppedCount = 0;
+
+void backlogPush(int channel, const uint16_t* samples, uint32_t timestampMs) {
+  if (count == BACKLOG_BUNDLES) {
+    #ifdef ENABLE_FLASH_SPOOL
+    // Outage outlived the ring: demote the oldest bundle to the spool
+    // tier (flash/PSRAM) instead of dropping it
+    if (!spoolPush(&ring[tail])) {
+      droppedCount++;
+      TLOG_WARN(TLOG_EVT_BACKLOG_DROP, (int32_t)droppedCount);
+    }
+    #else
+    // Outage outlived the ring: sacrifice the oldest bundle
+    droppedCount++;
+    TLOG_WARN(TLOG_EVT_BACKLOG_DROP, (int32_t)droppedCount);
+    #endif
+    tail = (tail + 1) % BACKLOG_BUNDLES;
+    count--;
+  }
+
+  ring[head].timestampMs = timestampMs;
+  ring[head].channel = (uint8_t)channel;
+  memcpy(ring[head].samples, samples, sizeof(ring[head].samples));
+  head = (head + 1) % BACKLOG_BUNDLES;
+  count++;
+}
+
+bool backlogPop(BundleRecord* out) {
+  #ifdef ENABLE_FLASH_SPOOL
+  // The spool tier always holds older records than the RAM ring, so it
+  // drains first to keep the replay in timestamp order
+  if (spoolPop(out)) {
+    return true;
+  }
+  #endif
+
+  if (count == 0) {
+    return false;
+  }
+  *out = ring[tail];
+  tail = (tail + 1) % BACKLOG_BUNDLES;
+  count--;
+  return true;
+}
+
+int backlogCount() {
+  return count + spoolCount();
+}
+
+uint32_t backlogDroppedCount() {
+  return droppedCount + spoolDroppedCount();
+}
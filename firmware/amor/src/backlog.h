@@ -0,0 +1,50 @@
+/*
+ * Amor ESP32 Firmware - Store-and-forward outage buffer
+ *
+ * When WiFi is down, sendPPGBundle() used to drop the bundle on the floor —
+ * a 30-second AP hiccup cost 1500 samples per unit and a hole in the beat
+ * stream. Sealed bundles are now spooled into this ring during outages and
+ * drained in batches after reconnect, faster than real time, so the server's
+ * view is current again within a second or two.
+ *
+ * Each record keeps its original grid timestamp, so replayed bundles are
+ * indistinguishable from live ones apart from arrival time.
+ */
+
+#ifndef BACKLOG_H
+#define BACKLOG_H
+
+#include <stdint.h>
+#include "../include/config.h"
+
+// Capacity in bundles. Default covers BACKLOG_SECONDS of outage at the
+// bundle rate (~8.4KB of RAM at the default 60s / BUNDLE_SIZE 5).
+#ifndef BACKLOG_SECONDS
+#define BACKLOG_SECONDS 60
+#endif
+#define BACKLOG_BUNDLES ((BACKLOG_SECONDS * SAMPLE_RATE_HZ) / BUNDLE_SIZE)
+
+// How many backlogged bundles to send per drain call. At one drain per
+// bundle interval this catches up ~20x faster than real time.
+#define BACKLOG_DRAIN_PER_CALL 20
+
+// One sealed bundle awaiting transmission.
+struct BundleRecord {
+  uint32_t timestampMs;              // Grid time of first sample
+  uint8_t channel;                   // Board channel (0 on single-sensor units)
+  uint16_t samples[BUNDLE_SIZE];
+};
+
+// Append a sealed bundle; overwrites the oldest record when full.
+void backlogPush(int channel, const uint16_t* samples, uint32_t timestampMs);
+
+// Pop the oldest record. Returns false if the backlog is empty.
+bool backlogPop(BundleRecord* out);
+
+// Bundles currently waiting.
+int backlogCount();
+
+// Bundles overwritten before they could be sent (outage outlived the ring).
+uint32_t backlogDroppedCount();
+
+#endif // BACKLOG_H
@@ -0,0 +1,99 @@
+#include <Arduino.h>
+#include <OSCMessage.h>
+#include "clock_sync.h"
+#include "../include/config.h"
+
+// Accept a pong only if its RTT is within this factor of the best seen;
+// anything slower was queued somewhere and its midpoint is unreliable.
+#define RTT_ACCEPT_FACTOR 3 / 2
+
+// EMA weights (out of 16) for offset and drift updates
+#define OFFSET_EMA_WEIGHT 4
+#define DRIFT_EMA_WEIGHT 2
+
+static WiFiUDP* sock = NULL;
+static IPAddress serverAddr;
+
+static int32_t pingSeq = 0;
+static unsigned long lastPingTime = 0;
+
+static bool synced = false;
+static int64_t offsetMs = 0;          // server clock - local clock
+static int32_t driftPpb = 0;          // offset change, parts per billion
+static uint32_t lastAcceptLocalMs = 0;
+static uint32_t bestRttMs = 0xFFFFFFFF;
+
+void setupClockSync(WiFiUDP* udpSock, IPAddress server) {
+  sock = udpSock;
+  serverAddr = server;
+}
+
+void clockSyncTick(bool wifiConnected) {
+  if (!wifiConnected || sock == NULL) {
+    return;
+  }
+
+  unsigned long now = millis();
+  if (lastPingTime != 0 && now - lastPingTime < SYNC_INTERVAL_MS) {
+    return;
+  }
+  lastPingTime = now;
+
+  // Low-rate control traffic; OSCMessage is fine here
+  OSCMessage msg("/sync/ping");
+  msg.add((int32_t)PPG_ID);
+  msg.add(++pingSeq);
+  msg.add((int32_t)millis());   // t1 as late as possible before send
+
+  sock->beginPacket(serverAddr, SYNC_PORT);
+  msg.send(*sock);
+  sock->endPacket();
+  msg.empty();
+}
+
+void clockSyncHandlePong(int32_t seq, uint32_t t1Ms, uint32_t serverMs) {
+  uint32_t t2Ms = millis();
+
+  if (seq != pingSeq) {
+    return;  // stale or duplicated pong
+  }
+
+  uint32_t rttMs = t2Ms - t1Ms;
+  if (rttMs < bestRttMs) {
+    bestRttMs = rttMs;
+  } else if (rttMs > bestRttMs * RTT_ACCEPT_FACTOR + 2) {
+    return;  // inflated RTT; midpoint assumption would skew the offset
+  }
+
+  // Midpoint estimate: server clock when our clock read t2
+  int64_t newOffset = (int64_t)serverMs + (int64_t)(rttMs / 2) - (int64_t)t2Ms;
+
+  if (!synced) {
+    offsetMs = newOffset;
+    synced = true;
+  } else {
+    // Drift first: offset delta per elapsed local time, in ppb
+    uint32_t elapsedMs = t2Ms - lastAcceptLocalMs;
+    if (elapsedMs > 1000) {
+      int32_t newDriftPpb =
+          (int32_t)(((newOffset - offsetMs) * 1000000000LL) / elapsedMs);
+      driftPpb += ((newDriftPpb - driftPpb) * DRIFT_EMA_WEIGHT) / 16;
+    }
+    offsetMs += ((newOffset - offsetMs) * OFFSET_EMA_WEIGHT) / 16;
+  }
+
+  lastAcceptLocalMs = t2Ms;
+}
+
+uint32_t clockSyncToServerMs(uint32_t localMs) {
+  if (!synced) {
+    return localMs;
+  }
+  int64_t driftCorrection =
+      ((int64_t)(int32_t)(localMs - lastAcceptLocalMs) * driftPpb) / 1000000000LL;
+  return (uint32_t)((int64_t)localMs + offsetMs + driftCorrection);
+}
+
+bool clockSyncIsSynced() {
+  return synced;
+}
@@ -0,0 +1,57 @@
+/*
+ * Amor ESP32 Firmware - Clock synchronization with the server
+ *
+ * Bundles used to carry local millis() timestamps, forcing the server to
+ * estimate each unit's clock offset and drift from packet arrival times —
+ * mushy on busy WiFi. This module runs a lightweight NTP-style exchange
+ * over the admin socket instead:
+ *
+ *   every SYNC_INTERVAL_MS the unit sends
+ *       /sync/ping [ppg_id, seq, t1_ms]        (t1 = local clock at TX)
+ *   the server's responder (SERVER_IP:SYNC_PORT) replies to ADMIN_PORT with
+ *       /sync/pong [seq, t1_ms, server_ms]     (server clock at response)
+ *
+ * On receipt at local time t2, RTT = t2 - t1 and the offset estimate is
+ * server_ms + RTT/2 - t2. Exchanges with inflated RTT (retries, queueing)
+ * are discarded against the best RTT seen; accepted offsets feed an EMA
+ * plus a drift estimate (ppm) so the conversion stays accurate between
+ * exchanges. clockSyncToServerMs() then lets bundle and beat timestamps
+ * be expressed directly in server time.
+ *
+ * Requires ENABLE_OSC_ADMIN (the pong arrives on the admin socket).
+ */
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdint.h>
+#include <IPAddress.h>
+#include <WiFiUdp.h>
+
+#ifndef SYNC_INTERVAL_MS
+#define SYNC_INTERVAL_MS 10000
+#endif
+
+// Port of the server-side sync responder.
+#ifndef SYNC_PORT
+#define SYNC_PORT 8007
+#endif
+
+// Register the socket to ping from (the bound admin socket, so the pong
+// comes back to ADMIN_PORT) and the server address.
+void setupClockSync(WiFiUDP* sock, IPAddress server);
+
+// Call periodically from the network task; sends a ping when one is due.
+void clockSyncTick(bool wifiConnected);
+
+// Feed a received /sync/pong.
+void clockSyncHandlePong(int32_t seq, uint32_t t1Ms, uint32_t serverMs);
+
+// Convert a local millis() value to server time. Identity until the first
+// successful exchange.
+uint32_t clockSyncToServerMs(uint32_t localMs);
+
+// True once at least one exchange has been accepted.
+bool clockSyncIsSynced();
+
+#endif // CLOCK_SYNC_H
@@ -0,0 +1,66 @@
+#include <Arduino.h>
+#include "espnow_out.h"
+#include "../include/config.h"
+
+#ifdef ENABLE_ESPNOW
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+
+static uint8_t peerMac[6] = ESPNOW_PEER_MAC;
+static bool ready = false;
+static uint32_t errorCount = 0;
+
+// Runs on the WiFi task after each frame: ESP-NOW acks at the MAC layer,
+// so a failed status means the bridge really didn't get it.
+static void onSent(const uint8_t* mac, esp_now_send_status_t status) {
+  if (status != ESP_NOW_SEND_SUCCESS) {
+    errorCount++;
+  }
+}
+
+bool espnowOutSetup() {
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();  // no association; frames go straight to the peer
+
+  // Both ends must sit on the same fixed channel (no AP to agree through)
+  esp_wifi_set_channel(ESPNOW_WIFI_CHANNEL, WIFI_SECOND_CHAN_NONE);
+
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("ERROR: ESP-NOW init failed");
+    return false;
+  }
+  esp_now_register_send_cb(onSent);
+
+  esp_now_peer_info_t peer = {};
+  memcpy(peer.peer_addr, peerMac, sizeof(peerMac));
+  peer.channel = ESPNOW_WIFI_CHANNEL;
+  peer.ifidx = WIFI_IF_STA;
+  peer.encrypt = false;
+  if (esp_now_add_peer(&peer) != ESP_OK) {
+    Serial.println("ERROR: ESP-NOW peer registration failed");
+    return false;
+  }
+
+  ready = true;
+  return true;
+}
+
+bool espnowOutSend(const uint8_t* data, size_t len) {
+  if (!ready || len > ESP_NOW_MAX_DATA_LEN) {
+    errorCount++;
+    return false;
+  }
+  if (esp_now_send(peerMac, data, len) != ESP_OK) {
+    errorCount++;
+    return false;
+  }
+  return true;
+}
+
+uint32_t espnowOutErrorCount() {
+  return errorCount;
+}
+
+#endif // ENABLE_ESPNOW
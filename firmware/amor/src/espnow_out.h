@@ -0,0 +1,39 @@
+/*
+ * Amor ESP32 Firmware - ESP-NOW transmit path
+ *
+ * Alternative to the UDP path (udp_out.h) for venues where the AP is the
+ * problem: ESP-NOW frames are raw 802.11 action frames to a dedicated
+ * bridge ESP32 (which forwards the payload verbatim to the server over
+ * Ethernet/USB). No association, no DHCP, no AP queue — delivery is
+ * single-digit milliseconds and survives AP reboots entirely, and the
+ * radio duty cycle drops with it.
+ *
+ * The payload is the same preformatted OSC datagram the UDP path sends,
+ * so the bridge needs no protocol knowledge beyond "wrap in UDP and
+ * forward". ESP-NOW caps frames at 250 bytes; every bundle and beat
+ * datagram fits with room to spare.
+ *
+ * Enabled with ENABLE_ESPNOW in config.h (plus ESPNOW_PEER_MAC and
+ * ESPNOW_WIFI_CHANNEL). Replaces the IP stack entirely: the admin
+ * channel, clock sync and timing stats all ride UDP and are unavailable
+ * in this mode.
+ */
+
+#ifndef ESPNOW_OUT_H
+#define ESPNOW_OUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bring up the radio on ESPNOW_WIFI_CHANNEL and register the bridge peer.
+// Returns false if ESP-NOW init or peer registration fails.
+bool espnowOutSetup();
+
+// Send one preformatted datagram to the bridge. Returns false if the
+// frame was refused or oversized (counted; see espnowOutErrorCount).
+bool espnowOutSend(const uint8_t* data, size_t len);
+
+// Frames refused by the stack or not acked by the bridge.
+uint32_t espnowOutErrorCount();
+
+#endif // ESPNOW_OUT_H
@@ -0,0 +1,80 @@
+#include "link_adapt.h"
+
+#ifdef ENABLE_LINK_ADAPT
+
+#include <WiFi.h>
+#include "telemetry_log.h"
+
+// The radio's supported power levels in quarter-dBm (the wifi_power_t
+// enum values): 2dBm up to 19.5dBm.
+static const int8_t notches[] = {8, 20, 28, 34, 44, 52, 60, 68, 74, 78, 84};
+static const int notchCount = sizeof(notches) / sizeof(notches[0]);
+
+static int notch = 1;               // Index into notches[]
+static uint32_t lastSentTotal = 0;
+static uint32_t lastNackedTotal = 0;
+static int cleanWindows = 0;
+static uint32_t stepCount = 0;
+
+static void applyNotch(int next, int32_t lossPermille, int rssiDbm) {
+  if (next < 0 || next >= notchCount || next == notch) {
+    return;
+  }
+  notch = next;
+  cleanWindows = 0;
+  stepCount++;
+  WiFi.setTxPower((wifi_power_t)notches[notch]);
+  TLOG_INFO(TLOG_EVT_TX_POWER, (int32_t)notches[notch], lossPermille,
+            (int32_t)rssiDbm);
+}
+
+void linkAdaptInit(int startQdbm) {
+  notch = 0;
+  for (int i = 0; i < notchCount; i++) {
+    if (notches[i] <= startQdbm) {
+      notch = i;
+    }
+  }
+}
+
+void linkAdaptTick(bool connected, int rssiDbm, uint32_t sentTotal,
+                   uint32_t nackedTotal) {
+  uint32_t sent = sentTotal - lastSentTotal;
+  uint32_t nacked = nackedTotal - lastNackedTotal;
+  lastSentTotal = sentTotal;
+  lastNackedTotal = nackedTotal;
+
+  // A window with no association or no traffic says nothing about the
+  // power level; don't let it count toward a downward step either
+  if (!connected || sent == 0) {
+    cleanWindows = 0;
+    return;
+  }
+
+  int32_t lossPermille = (int32_t)((uint64_t)nacked * 1000 / sent);
+
+  if (lossPermille > LINK_LOSS_TARGET_PERMILLE ||
+      rssiDbm < LINK_RSSI_FLOOR_DBM) {
+    // Over budget (or about to be): step up immediately
+    applyNotch(notch + 1, lossPermille, rssiDbm);
+  } else if (lossPermille == 0 && rssiDbm > LINK_RSSI_CEILING_DBM) {
+    // Clean and close: earn a downward step slowly
+    cleanWindows++;
+    if (cleanWindows >= LINK_DOWN_DWELL) {
+      applyNotch(notch - 1, lossPermille, rssiDbm);
+    }
+  } else {
+    // In the comfortable band: hold
+    cleanWindows = 0;
+  }
+}
+
+int linkAdaptTxPowerQdbm() {
+  return notches[notch];
+}
+
+uint32_t linkAdaptStepCount() {
+  return stepCount;
+}
+
+#endif // ENABLE_LINK_ADAPT
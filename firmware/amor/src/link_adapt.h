@@ -0,0 +1,64 @@
+/*
+ * Amor ESP32 Firmware - Adaptive WiFi TX power and link telemetry
+ *
+ * TX power was a compile-time constant picked for the S3-Zero's antenna
+ * up close, but units move around the venue: at range a fixed 5dBm drops
+ * bundles, parked next to the AP it wastes transmit current. This
+ * controller steps WiFi.setTxPower through the radio's notch table
+ * against what the link actually reports — RSSI every window, plus the
+ * server's NACK rate as a delivered-vs-sent signal when
+ * ENABLE_SEQ_RETRANSMIT is on (without it, RSSI alone drives the loop).
+ *
+ * Stepping up is eager (one bad window), stepping down is reluctant
+ * (LINK_DOWN_DWELL consecutive clean windows), so the loop parks at the
+ * lowest power that holds the loss budget instead of oscillating. The
+ * current metrics go out as /link/{PPG_ID} alongside the other stats so
+ * per-unit link health is visible on the bus, not just over USB.
+ *
+ * Supersedes the static and /config/txpower settings while enabled (they
+ * seed the starting notch).
+ */
+
+#ifndef LINK_ADAPT_H
+#define LINK_ADAPT_H
+
+#include <stdint.h>
+#include "../include/config.h"
+
+// Loss budget per observation window, in bundles per thousand.
+#ifndef LINK_LOSS_TARGET_PERMILLE
+#define LINK_LOSS_TARGET_PERMILLE 10
+#endif
+
+// Step up when RSSI falls below the floor even with zero observed loss
+// (the link is about to get bad); consider stepping down only above the
+// ceiling.
+#ifndef LINK_RSSI_FLOOR_DBM
+#define LINK_RSSI_FLOOR_DBM -75
+#endif
+#ifndef LINK_RSSI_CEILING_DBM
+#define LINK_RSSI_CEILING_DBM -55
+#endif
+
+// Consecutive clean windows (5s each) before one downward step.
+#ifndef LINK_DOWN_DWELL
+#define LINK_DOWN_DWELL 6
+#endif
+
+// Seed the controller at the configured power (quarter-dBm, snapped to
+// the nearest radio notch).
+void linkAdaptInit(int startQdbm);
+
+// Feed one observation window; call on the 5s stats cadence with the
+// running totals (the controller diffs them itself). nackedTotal is 0 on
+// builds without ENABLE_SEQ_RETRANSMIT.
+void linkAdaptTick(bool connected, int rssiDbm, uint32_t sentTotal,
+                   uint32_t nackedTotal);
+
+// Current TX power in quarter-dBm; re-apply after every association.
+int linkAdaptTxPowerQdbm();
+
+// Power steps taken since boot (up + down), for the telemetry stream.
+uint32_t linkAdaptStepCount();
+
+#endif // LINK_ADAPT_H
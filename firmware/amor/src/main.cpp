@@ -2,9 +2,66 @@
 #include <WiFi.h>
 #include <WiFiUdp.h>
 #include <OSCMessage.h>
-#include <math.h>
 #include <esp_task_wdt.h>
 #include "../include/config.h"
+#include "sampler.h"
+#include "wire.h"
+#include "osc_out.h"
+#include "backlog.h"
+#include "spool.h"
+#include "timing_stats.h"
+#include "power.h"
+#include "udp_out.h"
+#include "runtime_config.h"
+#include "telemetry_log.h"
+#ifdef ENABLE_QUALITY_GATE
+#include "quality_gate.h"
+#endif
+#ifdef ENABLE_ESPNOW
+#include "espnow_out.h"
+#if defined(ENABLE_OSC_ADMIN) || defined(ENABLE_CLOCK_SYNC) || defined(ENABLE_TIMING_STATS)
+#error "ENABLE_ESPNOW replaces the IP stack; OSC admin, clock sync and timing stats need UDP"
+#endif
+#endif
+#ifdef ENABLE_CLOCK_SYNC
+#include "clock_sync.h"
+#ifndef ENABLE_OSC_ADMIN
+#error "ENABLE_CLOCK_SYNC requires ENABLE_OSC_ADMIN (pongs arrive on the admin socket)"
+#endif
+#endif
+#ifdef ENABLE_OTA_UPDATE
+#include "ota_update.h"
+#ifndef ENABLE_OSC_ADMIN
+#error "ENABLE_OTA_UPDATE requires ENABLE_OSC_ADMIN (the transfer runs over the admin socket)"
+#endif
+#endif
+#ifdef ENABLE_SEQ_RETRANSMIT
+#include "retransmit.h"
+#ifndef ENABLE_PACKED_BUNDLES
+#error "ENABLE_SEQ_RETRANSMIT rides in the versioned blob header and requires ENABLE_PACKED_BUNDLES (the classic all-int32 message has no room for a sequence field)"
+#endif
+#ifndef ENABLE_OSC_ADMIN
+#error "ENABLE_SEQ_RETRANSMIT requires ENABLE_OSC_ADMIN (NACKs arrive on the admin socket)"
+#endif
+#endif
+#ifdef ENABLE_LINK_ADAPT
+#include "link_adapt.h"
+#ifdef ENABLE_ESPNOW
+#error "ENABLE_LINK_ADAPT adapts the AP association; ESP-NOW has no association or RSSI to adapt to"
+#endif
+#endif
+#ifdef ENABLE_BEAT_DETECTOR
+#include <beat_detector.h>
+#endif
+#ifdef ENABLE_PPG_FILTER
+#include <ppg_filter.h>
+#endif
+#include <stream_stats.h>
+
+// Sensors multiplexed on this board; channel c streams as /ppg/{PPG_ID+c}
+#ifndef PPG_NUM_CHANNELS
+#define PPG_NUM_CHANNELS 1
+#endif
 
 // Watchdog timeout in seconds
 #define WDT_TIMEOUT 30
@@ -12,6 +69,27 @@
 // Maximum OSC message size (bytes)
 #define MAX_OSC_MESSAGE_SIZE 512
 
+// Core for the network task: WiFi, UDP send, admin, stats. The sampling task
+// is pinned to the other core (SAMPLING_CORE in sampler.cpp), so a blocking
+// reconnect can never stall the sample grid. Overridable from config.h.
+#ifndef NETWORK_CORE
+#define NETWORK_CORE 0
+#endif
+
+#define NETWORK_TASK_PRIORITY 2
+#define NETWORK_TASK_STACK 8192
+
+// Sender task: drains the sealed-bundle queue below the network task's
+// priority on the same core, so a radio wait inside a send is preempted
+// the moment the network task has sealing or admin work to do.
+#define SENDER_TASK_PRIORITY 1
+#define SENDER_TASK_STACK 4096
+
+// Sealed bundles awaiting the sender task. Small on purpose: the outage
+// backlog handles sustained WiFi-down periods; this only has to absorb
+// radio contention spikes of a few hundred milliseconds.
+#define TX_QUEUE_BUNDLES 8
+
 // ============================================================================
 // Constants (from config.h via macros)
 // ============================================================================
@@ -23,31 +101,42 @@
 // Global State
 // ============================================================================
 
+// Bundle assembly is per channel; everything starts zeroed.
+// wifiConnected is cleared from the WiFi stack's event task, hence volatile.
 struct {
-  bool wifiConnected;
-  uint16_t sampleBuffer[BUNDLE_SIZE];
-  int bufferIndex;
-  unsigned long bundleStartTime;
-  uint32_t bundlesSent;
-  uint16_t adcRingBuffer[50];
-  int adcRingIndex;
-  int sampleCount;  // Track actual samples in ring buffer (max 50)
-  unsigned long sampleGridBase;  // Fixed time reference for 50Hz grid
-  uint32_t sampleGridCount;      // Total samples taken on grid
-} state = {
-  .wifiConnected = false,
-  .bufferIndex = 0,
-  .bundleStartTime = 0,
-  .bundlesSent = 0,
-  .adcRingIndex = 0,
-  .sampleCount = 0,
-  .sampleGridBase = 0,
-  .sampleGridCount = 0
-};
+  volatile bool wifiConnected;
+  uint16_t sampleBuffer[PPG_NUM_CHANNELS][BUNDLE_SIZE];
+  int bufferIndex[PPG_NUM_CHANNELS];
+  unsigned long bundleStartTime[PPG_NUM_CHANNELS];
+} state = {};
+
+// Transmit counters live in RTC slow memory: initialized at power-on only,
+// preserved across watchdog/software resets so the serial stats resume
+// instead of restarting mid-show. (The sample grid itself re-bases on the
+// fresh millis() clock — timestamps are local-clock-relative by design,
+// and ENABLE_CLOCK_SYNC re-anchors them server-side after any reset.)
+RTC_DATA_ATTR uint32_t bundlesSent = 0;
+
+#ifdef ENABLE_SEQ_RETRANSMIT
+// Wire sequence number, stamped into every bundle's blob header. Resends
+// keep their original seq, so only transmitBundle() advances it. RTC-
+// resident like the counters above: after a warm reset the stream carries
+// on instead of restarting at zero, which the server would book as a
+// 4-billion-bundle gap.
+RTC_DATA_ATTR uint32_t txSeq = 0;
+uint32_t nacksReceived = 0;
+uint32_t bundlesResent = 0;
+uint32_t nackMisses = 0;  // NACKed seqs that had aged out of the history
+#endif
+
+// Incremental ADC statistics over a 1-second window: O(1) per sample, no
+// array scan when printStats() reads them, always-current variance for the
+// signal-quality logic
+StreamStats adcStats(SAMPLE_RATE_HZ);
 
 // Networking
 IPAddress serverIP;
-WiFiUDP udpSend;   // For sending PPG data to SERVER_PORT
+WiFiUDP udpSend;   // Low-rate traffic only (stats); bundles go via udp_out
 #ifdef ENABLE_OSC_ADMIN
 WiFiUDP udpRecv;   // For receiving admin commands on ADMIN_PORT
 #endif
@@ -62,6 +151,32 @@ unsigned long bootTime = 0;
 // LED
 bool ledState = false;
 
+// Power-on/brownout boots run the full diagnostics; warm resets (watchdog,
+// panic, /restart) take the fast path: no blink test, no CDC delay, and the
+// sample timer starts within the first few hundred milliseconds.
+bool coldBoot = true;
+
+// Set by the got-IP event handler; the network task performs the socket
+// rebinds at its next safe point (sockets are only ever touched there)
+volatile bool wifiRebindPending = false;
+
+// Sender task draining the sealed-bundle queue (see the Asynchronous
+// Bundle Transmission section)
+TaskHandle_t senderTaskHandle = NULL;
+
+#ifdef ENABLE_PPG_FILTER
+// On-device conditioning (DC removal + pulse bandpass, see lib/ppgfilter),
+// one filter state per channel
+PpgFilter ppgFilters[PPG_NUM_CHANNELS];
+#endif
+
+#ifdef ENABLE_BEAT_DETECTOR
+// On-device beat detection (ported PulseSensor state machine), one
+// independent detector per channel
+BeatDetector beatDetectors[PPG_NUM_CHANNELS];
+RTC_DATA_ATTR uint32_t beatsSent = 0;  // survives warm resets, see bundlesSent
+#endif
+
 // ============================================================================
 // Function Declarations
 // ============================================================================
@@ -74,33 +189,61 @@ void checkOSCMessages();
 void handleRestartCommand();
 void updateLED();
 void samplePPG();
-void sendPPGBundle();
+void sendPPGBundle(int channel);
+#ifdef ENABLE_BEAT_DETECTOR
+void sendBeatEvent(int channel, uint32_t timestampMs);
+#endif
 void printStats();
+#ifdef ENABLE_TIMING_STATS
+void sendTimingStats();
+#endif
+#ifdef ENABLE_LINK_ADAPT
+void sendLinkStats();
+#endif
+void networkTaskLoop(void* arg);
+void senderTaskLoop(void* arg);
+void txQueueQuiesce();
+#ifdef ENABLE_SEQ_RETRANSMIT
+void txEnqueueResend(uint32_t seq);
+#endif
 
 // ============================================================================
 // Setup
 // ============================================================================
 
 void setup() {
+  esp_reset_reason_t resetReason = esp_reset_reason();
+  coldBoot = (resetReason == ESP_RST_POWERON ||
+              resetReason == ESP_RST_BROWNOUT);
+
   #ifdef ENABLE_LED
-  // LED test first - blink rapidly to prove code is running
-  pinMode(LED_PIN, OUTPUT);
-  for (int i = 0; i < 20; i++) {
-    digitalWrite(LED_PIN, HIGH);
-    delay(100);
-    digitalWrite(LED_PIN, LOW);
-    delay(100);
+  if (coldBoot) {
+    // LED test first - blink rapidly to prove code is running
+    pinMode(LED_PIN, OUTPUT);
+    for (int i = 0; i < 20; i++) {
+      digitalWrite(LED_PIN, HIGH);
+      delay(100);
+      digitalWrite(LED_PIN, LOW);
+      delay(100);
+    }
   }
   #endif
 
   // Serial for debugging
   Serial.begin(115200);
-  delay(1000);  // Brief delay for USB CDC to stabilize
+  if (coldBoot) {
+    delay(1000);  // Brief delay for USB CDC to stabilize
+  }
 
   // Capture boot time for uptime calculation
   bootTime = millis();
 
   Serial.println("\n\n=== Amor ESP32 Firmware - Starting ===");
+  if (!coldBoot) {
+    Serial.print("Fast boot (reset reason ");
+    Serial.print(resetReason);
+    Serial.println("), diagnostics skipped");
+  }
   Serial.print("PPG ID: ");
   Serial.println(PPG_ID);
   Serial.print("PPG GPIO: ");
@@ -110,10 +253,55 @@ void setup() {
   Serial.print(":");
   Serial.println(SERVER_PORT);
 
-  // Initialize components
+  // Initialize components. Runtime config loads first so persisted
+  // overrides (rate, bundle size, TX power) shape everything downstream.
+  setupRuntimeConfig();
   setupLED();
   setupADC();
+  setupOSCOut();
+  setupSpool();
+
+  #if defined(ENABLE_BEAT_DETECTOR) && defined(ENABLE_RUNTIME_CONFIG)
+  // Rebuild the detectors in case a persisted rate changed the interval
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    beatDetectors[c] = BeatDetector((int)rcSampleIntervalMs());
+  }
+  #endif
+  #if defined(ENABLE_PPG_FILTER) && defined(ENABLE_RUNTIME_CONFIG)
+  // Filter corners are rate-relative; recompute for a persisted rate
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    ppgFilters[c] = PpgFilter((int)rcSampleRateHz());
+  }
+  #endif
+  #ifdef ENABLE_RUNTIME_CONFIG
+  adcStats.reset((int)rcSampleRateHz());  // keep the window at 1 second
+  #ifdef ENABLE_QUALITY_GATE
+  qualityGateReset();  // classifier windows track the rate too
+  #endif
+  #endif
+
+  // Start the hardware sample timer before anything network-related: the
+  // grid is live a few hundred milliseconds after reset, and samples buffer
+  // through the ring/backlog while WiFi comes up concurrently.
+  setupSampler();
+
+  #ifdef ENABLE_LINK_ADAPT
+  // The controller takes over from here; the configured power is only the
+  // starting notch
+  #ifdef ENABLE_RUNTIME_CONFIG
+  linkAdaptInit((int)rcTxPowerQdbm());
+  #else
+  linkAdaptInit(WIFI_POWER_5dBm);
+  #endif
+  #endif
+
   setupWiFi();
+  setupPower();
+
+  #ifdef ENABLE_CLOCK_SYNC
+  // Ping from the bound admin socket so pongs come back to ADMIN_PORT
+  setupClockSync(&udpRecv, serverIP);
+  #endif
 
   #ifdef ENABLE_WATCHDOG
   // Initialize watchdog timer
@@ -127,27 +315,27 @@ void setup() {
     Serial.println(err);
   }
 
-  err = esp_task_wdt_add(NULL);
-  if (err != ESP_OK) {
-    Serial.print("ERROR: Watchdog add task failed: ");
-    Serial.println(err);
-  } else {
-    // Reset watchdog immediately after successful initialization
-    esp_task_wdt_reset();
-    Serial.println("Watchdog initialized successfully");
-  }
+  // The network task subscribes itself once it starts; the watchdog then
+  // proves the core doing WiFi/send work is still making progress
+  Serial.println("Watchdog initialized successfully");
   #else
   Serial.println("Watchdog timer: DISABLED");
   #endif
 
-  Serial.println("Setup complete");
-
-  // Initialize sample grid for accurate 50Hz timing
-  state.sampleGridBase = millis();
-  state.sampleGridCount = 0;
-
   // Initialize stats timer
   lastStatsTime = millis();
+
+  // Log drain first (every task below logs to it), then the sender (the
+  // network task notifies it), then the network task; sampling is pinned
+  // to the other core (see sampler.cpp)
+  setupTelemetryLog();
+  xTaskCreatePinnedToCore(senderTaskLoop, "ppg_sender", SENDER_TASK_STACK,
+                          NULL, SENDER_TASK_PRIORITY, &senderTaskHandle,
+                          NETWORK_CORE);
+  xTaskCreatePinnedToCore(networkTaskLoop, "ppg_network", NETWORK_TASK_STACK,
+                          NULL, NETWORK_TASK_PRIORITY, NULL, NETWORK_CORE);
+
+  Serial.println("Setup complete");
 }
 
 // ============================================================================
@@ -166,12 +354,23 @@ void setupLED() {
 #endif
 
 void setupADC() {
-  // Configure ADC for PPG sensor
+  // Configure ADC for the PPG sensor(s)
   analogSetAttenuation(ADC_11db);
   analogReadResolution(12);
   adcAttachPin(PPG_GPIO);
+  #if PPG_NUM_CHANNELS >= 2
+  adcAttachPin(PPG_GPIO_2);
+  #endif
+  #if PPG_NUM_CHANNELS >= 3
+  adcAttachPin(PPG_GPIO_3);
+  #endif
+  #if PPG_NUM_CHANNELS >= 4
+  adcAttachPin(PPG_GPIO_4);
+  #endif
 
-  Serial.println("ADC configured: 12-bit, 0-4095 range");
+  Serial.print("ADC configured: 12-bit, 0-4095 range, ");
+  Serial.print(PPG_NUM_CHANNELS);
+  Serial.println(" channel(s)");
 }
 
 void scanWiFi() {
@@ -214,74 +413,100 @@ void scanWiFi() {
   WiFi.scanDelete();
 }
 
+#ifdef ENABLE_ESPNOW
+
+// ESP-NOW transport: no association, no DHCP, no sockets. The "link" is
+// connectionless, so it counts as up once the peer is registered; per-frame
+// MAC acks surface delivery failures via espnowOutErrorCount().
+void setupWiFi() {
+  Serial.print("ESP-NOW transport, channel ");
+  Serial.println(ESPNOW_WIFI_CHANNEL);
+  state.wifiConnected = espnowOutSetup();
+  lastWiFiAdminCheckTime = millis();
+}
+
+#else // !ENABLE_ESPNOW
+
+// WiFi event handlers run on the WiFi stack's own task. They only flip
+// flags; socket work happens on the network task (see checkWiFi()).
+void onWiFiGotIP(WiFiEvent_t event, WiFiEventInfo_t info) {
+  wifiRebindPending = true;
+}
+
+void onWiFiDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
+  // The stack auto-reconnects on its own (setAutoReconnect); nothing to do
+  // here beyond stopping sends until the next got-IP event
+  state.wifiConnected = false;
+}
+
 void setupWiFi() {
   Serial.print("Connecting to WiFi: ");
   Serial.println(WIFI_SSID);
 
   WiFi.mode(WIFI_STA);
+
+  // Event-driven reconnection: the stack retries associations itself and
+  // tells us when the interface is usable again. No blocking calls needed
+  // after this initial connect.
+  WiFi.onEvent(onWiFiGotIP, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+  WiFi.onEvent(onWiFiDisconnected, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  WiFi.setAutoReconnect(true);
+
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD, 0, NULL, true);  // true = connect to hidden network
+  #if defined(ENABLE_LINK_ADAPT)
+  WiFi.setTxPower((wifi_power_t)linkAdaptTxPowerQdbm());
+  #elif defined(ENABLE_RUNTIME_CONFIG)
+  WiFi.setTxPower((wifi_power_t)rcTxPowerQdbm());
+  #else
   WiFi.setTxPower(WIFI_POWER_5dBm);  // Reduce power for ESP32-S3-Zero
+  #endif
 
   // Parse server IP
   serverIP.fromString(SERVER_IP);
 
-  // Wait for initial connection (max 10 seconds)
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
-
-  if (WiFi.status() == WL_CONNECTED) {
-    state.wifiConnected = true;
-    Serial.println("\nWiFi connected!");
-    Serial.print("IP: ");
-    Serial.println(WiFi.localIP());
-
-    #ifdef ENABLE_OSC_ADMIN
-    // Start UDP for receiving admin commands
-    if (udpRecv.begin(ADMIN_PORT)) {
-      Serial.print("UDP receive initialized on port ");
-      Serial.println(ADMIN_PORT);
-    }
-    #endif
-    // udpSend doesn't need begin() - it's used only for outgoing packets
-  } else {
-    Serial.println("\nWiFi connection failed, will retry");
-    state.wifiConnected = false;
-  }
+  // No waiting here: association completes in the background, the got-IP
+  // event queues the socket binds, and the network task performs them
+  // (see checkWiFi()). Samples buffer through the backlog meanwhile.
+  Serial.println("Connecting in background...");
 
   lastWiFiAdminCheckTime = millis();
 }
 
+#endif // ENABLE_ESPNOW
+
 // ============================================================================
 // WiFi Management
 // ============================================================================
 
+#ifdef ENABLE_ESPNOW
 void checkWiFi() {
-  bool previousState = state.wifiConnected;
-  state.wifiConnected = (WiFi.status() == WL_CONNECTED);
-
-  if (!state.wifiConnected) {
-    if (previousState) {
-      Serial.println("WiFi disconnected, attempting to reconnect...");
-    } else {
-      Serial.print("WiFi still down, reconnecting... (status=");
-      Serial.print(WiFi.status());
-      Serial.println(")");
-    }
+  // Nothing to manage: no association to monitor, no sockets to rebind
+}
+#else
+// Reconnection itself is event-driven (onWiFiDisconnected/onWiFiGotIP plus
+// the stack's auto-reconnect), so nothing here blocks. This just performs
+// the socket rebinds queued by the got-IP handler — sends stay suppressed
+// (wifiConnected false) until the sockets are on the fresh interface.
+void checkWiFi() {
+  if (wifiRebindPending) {
+    wifiRebindPending = false;
 
-    // Try reconnect
-    WiFi.disconnect();
-    delay(100);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD, 0, NULL, true);  // true = connect to hidden network
-    WiFi.setTxPower(WIFI_POWER_5dBm);  // Set TX power AFTER begin()
-  } else if (state.wifiConnected && !previousState) {
-    Serial.println("WiFi reconnected!");
+    Serial.println("WiFi connected!");
     Serial.print("IP: ");
     Serial.println(WiFi.localIP());
 
+    // TX power must be re-applied after each association
+    #if defined(ENABLE_LINK_ADAPT)
+    WiFi.setTxPower((wifi_power_t)linkAdaptTxPowerQdbm());
+    #elif defined(ENABLE_RUNTIME_CONFIG)
+    WiFi.setTxPower((wifi_power_t)rcTxPowerQdbm());
+    #else
+    WiFi.setTxPower(WIFI_POWER_5dBm);
+    #endif
+
+    // Rebuild the connected send socket on the fresh interface
+    udpOutSetup(serverIP, SERVER_PORT);
+
     #ifdef ENABLE_OSC_ADMIN
     // Re-initialize UDP receive socket after reconnection
     udpRecv.stop();  // Clean shutdown of previous socket
@@ -292,14 +517,37 @@ void checkWiFi() {
       Serial.println("ERROR: UDP receive re-initialization failed");
     }
     #endif
+
+    state.wifiConnected = true;
+
+    #ifdef ENABLE_OTA_UPDATE
+    // Reaching the network is the health check that confirms an updated
+    // image (cancels a pending bootloader rollback, where supported)
+    otaMarkValid();
+    #endif
+  } else if (!state.wifiConnected) {
+    TLOG_WARN(TLOG_EVT_WIFI_DOWN, (int32_t)WiFi.status());
   }
 }
+#endif // ENABLE_ESPNOW
 
 // ============================================================================
 // OSC Admin Commands
 // ============================================================================
 
 #ifdef ENABLE_OSC_ADMIN
+#ifdef ENABLE_OTA_UPDATE
+// Reply to the sender of the datagram currently in udpRecv. OSCMessage
+// allocation is fine on the admin path (nowhere near the sampling hot
+// path, and the OTA chunk rate is bounded by this very round trip).
+static void sendAdminReply(OSCMessage& reply) {
+  udpRecv.beginPacket(udpRecv.remoteIP(), udpRecv.remotePort());
+  reply.send(udpRecv);
+  udpRecv.endPacket();
+  reply.empty();
+}
+#endif
+
 void checkOSCMessages() {
   // Check for incoming OSC messages on ADMIN_PORT
   int packetSize = udpRecv.parsePacket();
@@ -318,12 +566,162 @@ void checkOSCMessages() {
       handleRestartCommand();
     }
 
+    #ifdef ENABLE_CLOCK_SYNC
+    // Sync responder reply: [seq, t1_ms, server_ms]
+    if (msg.fullMatch("/sync/pong") && msg.size() >= 3) {
+      clockSyncHandlePong(msg.getInt(0), (uint32_t)msg.getInt(1),
+                          (uint32_t)msg.getInt(2));
+    }
+    #endif
+
+    #ifdef ENABLE_OTA_UPDATE
+    // Chunked firmware transfer into the inactive app partition; each
+    // stage answers the sender so the host tool can pace and retry.
+    // See ota_update.h for the protocol.
+    if (msg.fullMatch("/ota/begin") && msg.size() >= 2 && msg.isString(1)) {
+      char md5[40] = {0};
+      msg.getString(1, md5, sizeof(md5));
+      OSCMessage reply(otaBegin((size_t)msg.getInt(0), md5) ? "/ota/ready"
+                                                            : "/ota/error");
+      sendAdminReply(reply);
+    }
+
+    if (msg.fullMatch("/ota/data") && msg.size() >= 2) {
+      static uint8_t chunk[OTA_CHUNK_MAX];
+      int chunkLen = msg.getBlob(1, chunk, sizeof(chunk));
+      int acked = otaWriteChunk(msg.getInt(0), chunk, (size_t)chunkLen);
+      if (acked >= 0) {
+        OSCMessage reply("/ota/ack");
+        reply.add((int32_t)acked);
+        sendAdminReply(reply);
+      } else {
+        OSCMessage reply("/ota/error");
+        sendAdminReply(reply);
+      }
+    }
+
+    if (msg.fullMatch("/ota/end")) {
+      if (otaFinish()) {
+        OSCMessage reply("/ota/ok");
+        sendAdminReply(reply);
+        Serial.println("OTA: rebooting into the new image");
+        Serial.flush();
+        delay(100);
+        ESP.restart();
+      } else {
+        OSCMessage reply("/ota/error");
+        sendAdminReply(reply);
+      }
+    }
+
+    if (msg.fullMatch("/ota/abort")) {
+      otaAbort("host abort");
+    }
+
+    if (msg.fullMatch("/ota/rollback")) {
+      if (otaRollback()) {
+        Serial.println("OTA: rolling back to the previous image");
+        Serial.flush();
+        delay(100);
+        ESP.restart();
+      } else {
+        OSCMessage reply("/ota/error");
+        sendAdminReply(reply);
+      }
+    }
+    #endif // ENABLE_OTA_UPDATE
+
+    #ifdef ENABLE_SEQ_RETRANSMIT
+    // Selective retransmit: each int arg is one sequence number the server
+    // never saw. The requests join the transmit queue; the sender task
+    // resolves them against the history and resends with the original seq
+    // and timestamp so the receiver can close the hole in its accounting.
+    if (msg.fullMatch("/nack")) {
+      for (int i = 0; i < msg.size(); i++) {
+        nacksReceived++;
+        txEnqueueResend((uint32_t)msg.getInt(i));
+      }
+    }
+    #endif
+
+    #ifdef ENABLE_RUNTIME_CONFIG
+    // Runtime-tunable capture parameters; validated, persisted to NVS,
+    // applied live where the capture mode allows
+    if (msg.fullMatch("/config/rate") && msg.size() >= 1) {
+      uint32_t hz = (uint32_t)msg.getInt(0);
+      txQueueQuiesce();  // sender must be idle before history/grid changes
+      if (rcSetSampleRateHz(hz)) {
+        #ifdef ENABLE_BEAT_DETECTOR
+        // Detector timing is interval-based; rebuild them for the new grid
+        for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+          beatDetectors[c] = BeatDetector((int)rcSampleIntervalMs());
+        }
+        #endif
+        #ifdef ENABLE_PPG_FILTER
+        // Filter corners are rate-relative; recompute for the new grid
+        for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+          ppgFilters[c] = PpgFilter((int)rcSampleRateHz());
+        }
+        #endif
+        adcStats.reset((int)rcSampleRateHz());
+        #ifdef ENABLE_QUALITY_GATE
+        qualityGateReset();  // windows re-size; everyone streams for 1s
+        #endif
+        // Discard the partial bundles on the old grid
+        for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+          state.bufferIndex[c] = 0;
+        }
+        #ifdef ENABLE_SEQ_RETRANSMIT
+        retransmitReset();  // old-grid bundles shouldn't be resent
+        #endif
+        Serial.print("Config: sample rate set to ");
+        Serial.print(hz);
+        Serial.println("Hz");
+      } else {
+        Serial.println("Config: rejected /config/rate (want 10-500, divisor of 1000)");
+      }
+    }
+
+    if (msg.fullMatch("/config/bundle") && msg.size() >= 1) {
+      txQueueQuiesce();  // sender must be idle while templates re-render
+      if (rcSetBundleSize(msg.getInt(0))) {
+        for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+          state.bufferIndex[c] = 0;
+        }
+        #ifdef ENABLE_SEQ_RETRANSMIT
+        retransmitReset();  // history holds bundles of the old size
+        #endif
+        Serial.print("Config: bundle size set to ");
+        Serial.println(rcBundleSize());
+      } else {
+        Serial.println("Config: rejected /config/bundle (want 1..BUNDLE_SIZE)");
+      }
+    }
+
+    if (msg.fullMatch("/config/txpower") && msg.size() >= 1) {
+      if (rcSetTxPowerQdbm(msg.getInt(0))) {
+        Serial.print("Config: TX power set to ");
+        Serial.print(rcTxPowerQdbm() * 0.25f);
+        Serial.println("dBm");
+      } else {
+        Serial.println("Config: rejected /config/txpower (want 8..84 quarter-dBm)");
+      }
+    }
+
+    if (msg.fullMatch("/config/mode") && msg.size() >= 1) {
+      if (rcSetMode(msg.getInt(0))) {
+        Serial.print("Config: mode set to ");
+        Serial.println(rcMode());
+      } else {
+        Serial.println("Config: rejected /config/mode (beat modes need ENABLE_BEAT_DETECTOR)");
+      }
+    }
+    #endif // ENABLE_RUNTIME_CONFIG
+
     // Clear message to avoid memory leak
     msg.empty();
   } else if (packetSize > MAX_OSC_MESSAGE_SIZE) {
-    Serial.print("ERROR: OSC message too large (");
-    Serial.print(packetSize);
-    Serial.println(" bytes), ignoring");
+    TLOG_ERROR(TLOG_EVT_OVERSIZE_PACKET, (int32_t)packetSize);
     // Flush the oversized packet
     udpRecv.flush();
   }
@@ -373,81 +771,355 @@ void updateLED() {
 // ============================================================================
 
 void samplePPG() {
-  unsigned long currentTime = millis();
+  // Drain samples deposited by the hardware-timed sampling task. The ADC
+  // reads happen on the 50Hz hardware grid regardless of loop() latency;
+  // here we only bundle and forward them.
+  TimedSample timed;
+  while (samplerRead(&timed)) {
+    int c = timed.channel;
+    uint16_t value = timed.value;
+
+    #ifdef ENABLE_PPG_FILTER
+    // Condition before anything consumes the sample: DC removal + pulse
+    // bandpass, re-centered at mid-scale (see lib/ppgfilter)
+    value = ppgFilters[c].processSample(value);
+    #endif
 
-  // Calculate next scheduled sample time on fixed 20ms grid
-  unsigned long nextScheduledSample = state.sampleGridBase + (state.sampleGridCount * SAMPLE_INTERVAL_MS);
+    // Scheduled grid time of this sample (prevents drift in timestamps)
+    unsigned long sampleTime = samplerGridBaseMs() + (timed.gridIndex * rcSampleIntervalMs());
+    lastSampleTime = sampleTime;
 
-  // Sample at 50Hz (20ms intervals on fixed grid)
-  if (currentTime >= nextScheduledSample) {
-    // Use scheduled time (grid), not actual time (prevents drift)
-    lastSampleTime = nextScheduledSample;
-    state.sampleGridCount++;
+    #ifdef ENABLE_BEAT_DETECTOR
+    // Run the on-device detector; a beat event is one small packet instead
+    // of a continuous stream
+    if (beatDetectors[c].processSample(value) &&
+        rcMode() != RC_MODE_RAW) {
+      sendBeatEvent(c, (uint32_t)sampleTime);
+    }
+    #endif
 
-    // Record bundle start time on first sample (using grid time)
-    if (state.bufferIndex == 0) {
-      state.bundleStartTime = nextScheduledSample;
+    // Incremental rolling statistics (mean/stddev/min/max over 1s).
+    // The serial stats line tracks channel 0.
+    if (c == 0) {
+      adcStats.addSample(value);
     }
 
-    // Read ADC value (0-4095)
-    uint16_t sample = analogRead(PPG_GPIO);
-    state.sampleBuffer[state.bufferIndex++] = sample;
+    // Raw stream: without runtime config rcMode() folds to the compile-time
+    // flags (BEAT_EVENTS_ONLY suppresses it, exactly as before)
+    if (rcMode() != RC_MODE_BEATS) {
+      // Record bundle start time on first sample (using grid time)
+      if (state.bufferIndex[c] == 0) {
+        state.bundleStartTime[c] = sampleTime;
+      }
+
+      state.sampleBuffer[c][state.bufferIndex[c]++] = value;
+
+      // Send bundle when full
+      if (state.bufferIndex[c] >= rcBundleSize()) {
+        sendPPGBundle(c);
+        state.bufferIndex[c] = 0;
+      }
+    }
+  }
+}
+
+// ============================================================================
+// OSC Transmission
+// ============================================================================
+
+// Hot-path transport: ESP-NOW frames to the bridge, or the connected UDP
+// socket. Both take the same preformatted OSC datagram.
+static inline bool transportSend(const uint8_t* data, size_t len) {
+  #ifdef ENABLE_ESPNOW
+  return espnowOutSend(data, len);
+  #else
+  return udpOutSend(data, len);
+  #endif
+}
 
-    // Add sample to rolling statistics buffer
-    state.adcRingBuffer[state.adcRingIndex] = sample;
-    state.adcRingIndex = (state.adcRingIndex + 1) % 50;
-    if (state.sampleCount < 50) {
-      state.sampleCount++;
+// ============================================================================
+// Asynchronous Bundle Transmission
+// ============================================================================
+
+// Sealed bundles hand off to the sender task through this single-producer
+// (network task) / single-consumer (sender task) ring. A full queue drops
+// the bundle and counts it, so sealing and admin work never wait on the
+// radio. NACKed resend requests travel the same queue, which keeps the
+// osc_out /ppg templates and the retransmit history sender-task-only.
+struct TxRecord {
+  BundleRecord bundle;
+  #ifdef ENABLE_SEQ_RETRANSMIT
+  bool isResend;        // Look the bundle up in the history instead
+  uint32_t resendSeq;
+  #endif
+};
+
+static TxRecord txQueue[TX_QUEUE_BUNDLES];
+static volatile int txHead = 0;       // Next slot to write (network task)
+static volatile int txTail = 0;       // Oldest sealed record (sender task)
+static volatile bool txBusy = false;  // Sender is mid-transmit
+static uint32_t txDroppedCount = 0;
+
+// Producer side (network task only).
+static void txEnqueue(const TxRecord& record) {
+  int next = (txHead + 1) % TX_QUEUE_BUNDLES;
+  if (next == txTail) {
+    // Sender couldn't keep up: the radio stalled for longer than the
+    // queue covers. Counted, surfaced in the stats line.
+    txDroppedCount++;
+    TLOG_WARN(TLOG_EVT_TXQ_DROP, (int32_t)txDroppedCount);
+    return;
+  }
+  txQueue[txHead] = record;
+  txHead = next;
+  xTaskNotifyGive(senderTaskHandle);
+}
+
+// Seal one bundle into the transmit queue. Rendering and the send happen
+// on the sender task; this returns without touching the radio.
+static void transmitBundle(int channel, const uint16_t* samples,
+                           uint32_t timestampMs) {
+  #ifdef ENABLE_CLOCK_SYNC
+  // Express the wire timestamp in server time at seal time. Backlogged
+  // bundles still get a fresh offset/drift estimate (they are sealed here
+  // only when about to go out), and the sync state stays a network-task
+  // affair.
+  timestampMs = clockSyncToServerMs(timestampMs);
+  #endif
+
+  TxRecord record = {};
+  record.bundle.timestampMs = timestampMs;
+  record.bundle.channel = (uint8_t)channel;
+  memcpy(record.bundle.samples, samples, sizeof(record.bundle.samples));
+  txEnqueue(record);
+}
+
+#ifdef ENABLE_SEQ_RETRANSMIT
+// Queue a NACKed seq for resend; the sender task resolves it against the
+// history ring (and counts the miss if it has aged out).
+void txEnqueueResend(uint32_t seq) {
+  TxRecord record = {};
+  record.isResend = true;
+  record.resendSeq = seq;
+  txEnqueue(record);
+}
+#endif
+
+// Wait until the sender is idle. Called (on the network task) before
+// anything that re-renders the datagram templates or clears the
+// retransmit history, so those never race the sender's use of them. The
+// queue drains within a few milliseconds.
+void txQueueQuiesce() {
+  while (txTail != txHead || txBusy) {
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+}
+
+// Render one queue record through the precomputed datagram template and
+// send it. No allocation, no per-byte serialization — the address, type
+// tags and framing were rendered once at boot by setupOSCOut().
+static void senderTransmit(const TxRecord& record) {
+  size_t len;
+  const uint8_t* datagram;
+
+  #ifdef ENABLE_SEQ_RETRANSMIT
+  if (record.isResend) {
+    BundleRecord original;
+    if (!retransmitLookup(record.resendSeq, &original)) {
+      nackMisses++;  // aged out of the history ring
+      TLOG_DEBUG(TLOG_EVT_NACK_MISS, (int32_t)record.resendSeq);
+      return;
     }
+    datagram = oscOutRender(original.channel, original.samples,
+                            original.timestampMs, record.resendSeq, &len);
+    transportSend(datagram, len);
+    bundlesResent++;
+    return;
+  }
 
-    // Send bundle when full
-    if (state.bufferIndex >= BUNDLE_SIZE) {
-      sendPPGBundle();
-      state.bufferIndex = 0;
+  // Stamp and remember before sending; the history keeps the wire
+  // timestamp so a NACKed resend reproduces this datagram exactly
+  uint32_t seq = txSeq++;
+  datagram = oscOutRender(record.bundle.channel, record.bundle.samples,
+                          record.bundle.timestampMs, seq, &len);
+  retransmitRemember(seq, record.bundle.channel, record.bundle.samples,
+                     record.bundle.timestampMs);
+  #else
+  datagram = oscOutRender(record.bundle.channel, record.bundle.samples,
+                          record.bundle.timestampMs, &len);
+  #endif
+
+  transportSend(datagram, len);
+  bundlesSent++;
+}
+
+// Consumer side: block until the network task seals something, then
+// drain. Runs below the network task's priority on the same core, so time
+// spent inside a blocking send is taken back the moment there is sealing
+// or admin work to do.
+void senderTaskLoop(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdFALSE, pdMS_TO_TICKS(1000));
+    while (txTail != txHead) {
+      txBusy = true;
+      TxRecord record = txQueue[txTail];
+      txTail = (txTail + 1) % TX_QUEUE_BUNDLES;
+      senderTransmit(record);
+      txBusy = false;
     }
   }
 }
 
+#ifdef ENABLE_BEAT_DETECTOR
+// Send one /beat/N event: [timestamp_ms, ibi_ms, bpm, amplitude].
+// Beats during an outage are dropped — the raw-stream backlog (if enabled)
+// preserves the underlying samples for replay.
+// Beats stay on the network task (their own templates, latency-sensitive);
+// a send here concurrent with the sender task is fine, lwIP serializes
+// sends on the socket and ESP-NOW enqueue is thread-safe.
+void sendBeatEvent(int channel, uint32_t timestampMs) {
+  if (!state.wifiConnected) {
+    return;
+  }
+
+  #ifdef ENABLE_CLOCK_SYNC
+  timestampMs = clockSyncToServerMs(timestampMs);
+  #endif
+
+  size_t len;
+  const uint8_t* datagram = oscOutRenderBeat(
+      channel, timestampMs, beatDetectors[channel].getInterBeatIntervalMs(),
+      beatDetectors[channel].getBeatsPerMinute(),
+      beatDetectors[channel].getPulseAmplitude(), &len);
+
+  transportSend(datagram, len);
+
+  beatsSent++;
+}
+#endif // ENABLE_BEAT_DETECTOR
+
+void sendPPGBundle(int channel) {
+  #ifdef ENABLE_QUALITY_GATE
+  // Classify and gate before sealing or spooling: a suppressed bundle
+  // consumes no sequence number (no NACKable hole) and never reaches the
+  // backlog, so an unworn sensor can't fill the spool overnight
+  if (!qualityGateAdmit(channel, state.sampleBuffer[channel], rcBundleSize(),
+                        (uint32_t)state.bundleStartTime[channel])) {
+    return;
+  }
+  #endif
+
+  if (!state.wifiConnected) {
+    // Spool into the outage backlog instead of dropping; the original grid
+    // timestamp travels with the bundle for replay after reconnect
+    backlogPush(channel, state.sampleBuffer[channel],
+                (uint32_t)state.bundleStartTime[channel]);
+    return;
+  }
+
+  // Drain backlogged bundles first (in batches, ~20x faster than real
+  // time) so everything arrives in timestamp order
+  BundleRecord record;
+  int drained = 0;
+  while (drained < BACKLOG_DRAIN_PER_CALL && backlogPop(&record)) {
+    transmitBundle(record.channel, record.samples, record.timestampMs);
+    drained++;
+  }
+
+  if (backlogCount() > 0) {
+    // Still catching up: queue the live bundle behind the backlog to
+    // preserve ordering
+    backlogPush(channel, state.sampleBuffer[channel],
+                (uint32_t)state.bundleStartTime[channel]);
+  } else {
+    transmitBundle(channel, state.sampleBuffer[channel],
+                   (uint32_t)state.bundleStartTime[channel]);
+  }
+}
+
 // ============================================================================
-// OSC Transmission
+// Statistics
 // ============================================================================
 
-void sendPPGBundle() {
-  // Only send if WiFi is connected
+#ifdef ENABLE_TIMING_STATS
+// Publish the sampling-jitter window as /stats/{ppg_id}:
+//   [uptime_ms, ticks, missed_slots, overruns,
+//    jitter_samples, jitter_min_us, jitter_avg_us, jitter_max_us,
+//    hist_lt50us ... hist_ge5ms]
+// OSCMessage allocation is fine here: this runs every 5 seconds on the
+// network task, nowhere near the sampling hot path.
+void sendTimingStats() {
   if (!state.wifiConnected) {
     return;
   }
 
-  // Construct OSC address: /ppg/{ppg_id}
-  char address[20];
-  snprintf(address, sizeof(address), "/ppg/%d", PPG_ID);
+  TimingStatsSnapshot snap;
+  timingStatsSnapshot(&snap, true);
 
-  // Create OSC message
+  // Missed slots: ticks the hardware should have delivered by now but didn't
+  unsigned long elapsedMs = millis() - samplerGridBaseMs();
+  uint32_t expectedTicks = (uint32_t)((uint64_t)elapsedMs * samplerCaptureRateHz() / 1000);
+  uint32_t ticks = samplerTickCount();
+  int32_t missedSlots = (expectedTicks > ticks) ? (int32_t)(expectedTicks - ticks) : 0;
+
+  char address[20];
+  snprintf(address, sizeof(address), "/stats/%d", PPG_ID);
   OSCMessage msg(address);
 
-  // Add samples
-  for (int i = 0; i < BUNDLE_SIZE; i++) {
-    msg.add((int32_t)state.sampleBuffer[i]);
+  msg.add((int32_t)(millis() - bootTime));
+  msg.add((int32_t)ticks);
+  msg.add(missedSlots);
+  msg.add((int32_t)samplerOverrunCount());
+  msg.add((int32_t)snap.samples);
+  msg.add(snap.minUs);
+  msg.add(snap.avgUs);
+  msg.add(snap.maxUs);
+  for (int i = 0; i < TIMING_STATS_BUCKETS; i++) {
+    msg.add((int32_t)snap.histogram[i]);
   }
 
-  // Add timestamp (millis when first sample taken)
-  msg.add((int32_t)state.bundleStartTime);
-
-  // Send via UDP
   udpSend.beginPacket(serverIP, SERVER_PORT);
   msg.send(udpSend);
   udpSend.endPacket();
-
-  // CRITICAL: Clear message to avoid memory leak
   msg.empty();
-
-  // Increment bundle counter
-  state.bundlesSent++;
 }
+#endif // ENABLE_TIMING_STATS
+
+#ifdef ENABLE_LINK_ADAPT
+// Publish link health as /link/{ppg_id}:
+//   [rssi_dbm, txpower_qdbm, power_steps, bundles_sent,
+//    nacks, resent, txq_dropped]
+// OSCMessage allocation is fine on the 5-second cadence. The NACK fields
+// are zero on builds without ENABLE_SEQ_RETRANSMIT (RSSI alone drives
+// the power controller there).
+void sendLinkStats() {
+  if (!state.wifiConnected) {
+    return;
+  }
 
-// ============================================================================
-// Statistics
-// ============================================================================
+  char address[20];
+  snprintf(address, sizeof(address), "/link/%d", PPG_ID);
+  OSCMessage msg(address);
+
+  msg.add((int32_t)WiFi.RSSI());
+  msg.add((int32_t)linkAdaptTxPowerQdbm());
+  msg.add((int32_t)linkAdaptStepCount());
+  msg.add((int32_t)bundlesSent);
+  #ifdef ENABLE_SEQ_RETRANSMIT
+  msg.add((int32_t)nacksReceived);
+  msg.add((int32_t)bundlesResent);
+  #else
+  msg.add((int32_t)0);
+  msg.add((int32_t)0);
+  #endif
+  msg.add((int32_t)txDroppedCount);
+
+  udpSend.beginPacket(serverIP, SERVER_PORT);
+  msg.send(udpSend);
+  udpSend.endPacket();
+  msg.empty();
+}
+#endif // ENABLE_LINK_ADAPT
 
 void printStats() {
   unsigned long currentTime = millis();
@@ -464,103 +1136,200 @@ void printStats() {
   pos += written;
   remaining -= written;
 
-  // WiFi status
+  // Link status
+  #ifdef ENABLE_ESPNOW
+  written = snprintf(pos, remaining, " | ESP-NOW: %s (%lu send errs)",
+                     state.wifiConnected ? "OK" : "DOWN",
+                     espnowOutErrorCount());
+  #else
   if (state.wifiConnected) {
     int rssi = WiFi.RSSI();
+    #ifdef ENABLE_LINK_ADAPT
+    written = snprintf(pos, remaining, " | WiFi: OK (%s, %ddBm, TX %.1fdBm)",
+                       WiFi.localIP().toString().c_str(), rssi,
+                       linkAdaptTxPowerQdbm() * 0.25f);
+    #else
     written = snprintf(pos, remaining, " | WiFi: OK (%s, %ddBm)",
                        WiFi.localIP().toString().c_str(), rssi);
+    #endif
   } else {
     written = snprintf(pos, remaining, " | WiFi: DOWN");
   }
+  #endif
   pos += written;
   remaining -= written;
 
   // Bundles and samples
-  uint32_t totalSamplesSent = state.bundlesSent * BUNDLE_SIZE;
+  uint32_t totalSamplesSent = bundlesSent * rcBundleSize();
   written = snprintf(pos, remaining, " | Sent: %lu bundles (%lu samples)",
-                     state.bundlesSent, totalSamplesSent);
+                     bundlesSent, totalSamplesSent);
   pos += written;
   remaining -= written;
 
-  // ADC Statistics (only if we have at least 10 samples)
-  if (state.sampleCount >= 10) {
-    uint32_t sum = 0;
-    uint16_t minVal = 4095;
-    uint16_t maxVal = 0;
-
-    for (int i = 0; i < state.sampleCount; i++) {
-      uint16_t val = state.adcRingBuffer[i];
-      sum += val;
-      if (val < minVal) minVal = val;
-      if (val > maxVal) maxVal = val;
-    }
-
-    // Calculate mean
-    uint16_t mean = sum / state.sampleCount;
-
-    // Calculate standard deviation
-    uint32_t sumSqDiff = 0;
-    for (int i = 0; i < state.sampleCount; i++) {
-      int32_t diff = (int32_t)state.adcRingBuffer[i] - (int32_t)mean;
-      sumSqDiff += diff * diff;
-    }
-    uint16_t stddev = (uint16_t)sqrt((double)sumSqDiff / state.sampleCount);
+  #ifdef ENABLE_BEAT_DETECTOR
+  written = snprintf(pos, remaining, " | Beats: %lu (%d BPM)",
+                     beatsSent, beatDetectors[0].getBeatsPerMinute());
+  pos += written;
+  remaining -= written;
+  #endif
 
+  // ADC Statistics (only if we have at least 10 samples). Maintained
+  // incrementally as samples arrive; reading them here is O(1).
+  if (adcStats.count() >= 10) {
     written = snprintf(pos, remaining, " | ADC: %u±%u (%u-%u)",
-                       mean, stddev, minVal, maxVal);
+                       adcStats.mean(), adcStats.stddev(),
+                       adcStats.minimum(), adcStats.maximum());
     pos += written;
     remaining -= written;
   }
 
   // Message rate (bundles per second)
-  float rate = (uptimeSec > 0) ? ((float)state.bundlesSent / uptimeSec) : 0.0f;
+  float rate = (uptimeSec > 0) ? ((float)bundlesSent / uptimeSec) : 0.0f;
   written = snprintf(pos, remaining, " | Rate: %.1f msg/s", rate);
   pos += written;
   remaining -= written;
 
-  // Print single line
-  Serial.println(statsLine);
+  #ifdef ENABLE_QUALITY_GATE
+  // Gate status (channel 0) once anything has been classified or gated
+  if (qualityGateState(0) != QG_ACTIVE || qualityGateSuppressedCount() > 0) {
+    static const char* const qgNames[] = {"active", "flat", "noisy"};
+    written = snprintf(pos, remaining, " | Signal: %s (%lu gated)",
+                       qgNames[qualityGateState(0)],
+                       qualityGateSuppressedCount());
+    pos += written;
+    remaining -= written;
+  }
+  #endif
+
+  #ifdef ENABLE_SEQ_RETRANSMIT
+  // NACK traffic (only once the server has asked for something)
+  if (nacksReceived > 0) {
+    written = snprintf(pos, remaining, " | NACK: %lu (%lu resent, %lu aged)",
+                       nacksReceived, bundlesResent, nackMisses);
+    pos += written;
+    remaining -= written;
+  }
+  #endif
+
+  // Outage backlog (only when catching up or bundles were lost)
+  if (backlogCount() > 0 || backlogDroppedCount() > 0) {
+    written = snprintf(pos, remaining, " | Backlog: %d (%lu lost)",
+                       backlogCount(), backlogDroppedCount());
+    pos += written;
+    remaining -= written;
+  }
+
+  // Transmit queue overflow (sender task outpaced by sealing)
+  if (txDroppedCount > 0) {
+    written = snprintf(pos, remaining, " | TxQ: %lu dropped", txDroppedCount);
+    pos += written;
+    remaining -= written;
+  }
+
+  // Log records lost to a starved drain task
+  if (tlogDroppedCount() > 0) {
+    written = snprintf(pos, remaining, " | Log: %lu dropped",
+                       tlogDroppedCount());
+    pos += written;
+    remaining -= written;
+  }
+
+  // Assembly above is microseconds; the ~20ms UART write is what blocks,
+  // and that happens on the log drain task
+  tlogPrintLine(statsLine);
 }
 
 // ============================================================================
-// Main Loop
+// Network Task and Main Loop
 // ============================================================================
 
-void loop() {
-  unsigned long currentTime = millis();
+// Everything that can block on the radio lives here, pinned to NETWORK_CORE.
+// The sampling task on the other core keeps the 50Hz grid no matter how long
+// a WiFi reconnect or UDP send takes; this task just has to drain the ring
+// before it fills (1.28s of headroom).
+void networkTaskLoop(void* arg) {
+  #ifdef ENABLE_WATCHDOG
+  esp_task_wdt_add(NULL);
+  #endif
 
-  // Sample PPG at 50Hz (non-blocking)
-  samplePPG();
+  for (;;) {
+    unsigned long currentTime = millis();
 
-  // Check WiFi and admin commands every 3 seconds
-  if (currentTime - lastWiFiAdminCheckTime >= WIFI_ADMIN_CHECK_INTERVAL_MS) {
-    lastWiFiAdminCheckTime = currentTime;
-    checkWiFi();
-    #ifdef ENABLE_OSC_ADMIN
+    // Bundle and send samples captured on the other core (non-blocking)
+    samplePPG();
+
+    #ifndef ENABLE_ESPNOW
+    // Bind sockets promptly after a got-IP event instead of waiting out
+    // the 3-second check interval (the flag test is one load)
+    if (wifiRebindPending) {
+      checkWiFi();
+    }
+    #endif
+
+    #if defined(ENABLE_OSC_ADMIN) && defined(ENABLE_CLOCK_SYNC)
+    // Poll the admin socket every iteration: the pong RTT measurement
+    // needs prompt reads, and parsePacket() on an empty socket is cheap
     checkOSCMessages();
+    #elif defined(ENABLE_OTA_UPDATE)
+    // During a transfer the ack-per-chunk protocol needs prompt reads
+    // too; outside one the admin socket stays on the 3-second cadence
+    if (otaActive()) {
+      checkOSCMessages();
+    }
     #endif
-    #ifdef ENABLE_WATCHDOG
-    esp_task_wdt_reset();  // Reset watchdog to prove firmware health
+    #ifdef ENABLE_OTA_UPDATE
+    otaTick();  // abandons a transfer whose sender went away
     #endif
-  }
 
-  // Print statistics every 5 seconds
-  if (currentTime - lastStatsTime >= 5000) {
-    lastStatsTime = currentTime;
-    printStats();
-  }
+    // Check WiFi and admin commands every 3 seconds
+    if (currentTime - lastWiFiAdminCheckTime >= WIFI_ADMIN_CHECK_INTERVAL_MS) {
+      lastWiFiAdminCheckTime = currentTime;
+      checkWiFi();
+      #if defined(ENABLE_OSC_ADMIN) && !defined(ENABLE_CLOCK_SYNC)
+      checkOSCMessages();
+      #endif
+      #ifdef ENABLE_CLOCK_SYNC
+      clockSyncTick(state.wifiConnected);  // self-limits to SYNC_INTERVAL_MS
+      #endif
+      #ifdef ENABLE_WATCHDOG
+      esp_task_wdt_reset();  // Reset watchdog to prove firmware health
+      #endif
+    }
 
-  // Update LED feedback
-  updateLED();
-
-  // Sleep until next sample time to save power
-  unsigned long nextSampleTime = lastSampleTime + SAMPLE_INTERVAL_MS;
-  currentTime = millis();  // Re-read time after all operations
-  if (currentTime < nextSampleTime) {
-    unsigned long sleepTimeMs = nextSampleTime - currentTime;
-    if (sleepTimeMs > 0) {
-      // Use delay() which yields to FreeRTOS scheduler for power savings
-      delay(sleepTimeMs);
+    // Print statistics every 5 seconds
+    if (currentTime - lastStatsTime >= 5000) {
+      lastStatsTime = currentTime;
+      printStats();
+      #ifdef ENABLE_TIMING_STATS
+      sendTimingStats();
+      #endif
+      #ifdef ENABLE_LINK_ADAPT
+      // One controller window per stats interval, then publish the result
+      int rssi = state.wifiConnected ? WiFi.RSSI() : 0;
+      #ifdef ENABLE_SEQ_RETRANSMIT
+      linkAdaptTick(state.wifiConnected, rssi, bundlesSent, nacksReceived);
+      #else
+      linkAdaptTick(state.wifiConnected, rssi, bundlesSent, 0);
+      #endif
+      sendLinkStats();
+      #endif
     }
+
+    // Update LED feedback
+    updateLED();
+
+    // Wake often enough to drain the sample ring promptly. With light
+    // sleep enabled, longer idle stretches let tickless idle actually
+    // drop into light sleep; the ring has over a second of headroom.
+    #ifdef ENABLE_LIGHT_SLEEP
+    vTaskDelay(pdMS_TO_TICKS(rcSampleIntervalMs()));
+    #else
+    vTaskDelay(pdMS_TO_TICKS(1));
+    #endif
   }
 }
+
+void loop() {
+  // All work happens in the sampling and network tasks
+  vTaskDelay(pdMS_TO_TICKS(1000));
+}
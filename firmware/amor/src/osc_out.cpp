@@ -0,0 +1,178 @@
+#include <string.h>
+#include <stdio.h>
+#include "osc_out.h"
+#include "wire.h"
+#include "runtime_config.h"
+#include "../include/config.h"
+
+// Sensors multiplexed on this board; channel c goes out as /ppg/{PPG_ID+c}
+// so every downstream consumer keeps working unchanged.
+#ifndef PPG_NUM_CHANNELS
+#define PPG_NUM_CHANNELS 1
+#endif
+
+// ============================================================================
+// Template Layout
+// ============================================================================
+
+// OSC pads strings and blobs to 4-byte boundaries.
+#define OSC_PAD4(n) (((n) + 3) & ~3)
+
+// Address "/ppg/N" is 6 chars for single-digit ids; allow two digits.
+#define OSC_ADDR_MAX 12
+
+#ifdef ENABLE_PACKED_BUNDLES
+// ",b" + NUL padded, then int32 blob size + padded blob bytes
+#define OSC_TAGS_LEN OSC_PAD4(2 + 1)
+#ifdef ENABLE_SEQ_RETRANSMIT
+// Version-2 blob: 4 extra header bytes for the sequence number
+#define OSC_BLOB_LEN PPG_WIRE_BLOB_SIZE_SEQ(BUNDLE_SIZE)
+#else
+#define OSC_BLOB_LEN PPG_WIRE_BLOB_SIZE(BUNDLE_SIZE)
+#endif
+#define OSC_ARGS_LEN (4 + OSC_PAD4(OSC_BLOB_LEN))
+#else
+// "," + one 'i' per sample + 'i' for timestamp + NUL, padded
+#define OSC_TAGS_LEN OSC_PAD4(1 + BUNDLE_SIZE + 1 + 1)
+#define OSC_ARGS_LEN ((BUNDLE_SIZE + 1) * 4)
+#endif
+
+#define OSC_DATAGRAM_MAX (OSC_PAD4(OSC_ADDR_MAX) + OSC_TAGS_LEN + OSC_ARGS_LEN)
+
+// One pre-rendered template per channel (the address differs; the rest of
+// the layout is identical across channels)
+static uint8_t datagrams[PPG_NUM_CHANNELS][OSC_DATAGRAM_MAX];
+static size_t datagramLen[PPG_NUM_CHANNELS];
+static size_t argsOffset[PPG_NUM_CHANNELS];
+
+// Samples per bundle. BUNDLE_SIZE is the compile-time maximum the buffers
+// are sized for; oscOutSetBundleSize() can shrink it at runtime.
+static int bundleCount = BUNDLE_SIZE;
+
+// /beat/N datagram: address (padded), ",iiii" tags (padded), 4 int32 args
+#define OSC_BEAT_MAX (OSC_PAD4(OSC_ADDR_MAX) + 8 + 16)
+static uint8_t beatDatagrams[PPG_NUM_CHANNELS][OSC_BEAT_MAX];
+static size_t beatDatagramLen[PPG_NUM_CHANNELS];
+static size_t beatArgsOffset[PPG_NUM_CHANNELS];
+
+static void putInt32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)(v & 0xFF);
+}
+
+// (Re)render the constant portion of one channel's /ppg datagram for the
+// current bundleCount. Cheap enough to redo on a /config/bundle change.
+static void renderPPGTemplate(int channel) {
+  uint8_t* datagram = datagrams[channel];
+  memset(datagram, 0, OSC_DATAGRAM_MAX);
+  uint8_t* p = datagram;
+
+  // Address, NUL-terminated and padded to 4 bytes
+  char address[OSC_ADDR_MAX];
+  int addrLen = snprintf(address, sizeof(address), "/ppg/%d",
+                         PPG_ID + channel);
+  memcpy(p, address, addrLen);
+  p += OSC_PAD4(addrLen + 1);
+
+  // Type tags, NUL-terminated and padded to 4 bytes
+  #ifdef ENABLE_PACKED_BUNDLES
+  p[0] = ',';
+  p[1] = 'b';
+  p += OSC_PAD4(2 + 1);
+
+  // Blob size prefix is constant too: only the payload bytes change
+  #ifdef ENABLE_SEQ_RETRANSMIT
+  size_t blobLen = PPG_WIRE_BLOB_SIZE_SEQ(bundleCount);
+  #else
+  size_t blobLen = PPG_WIRE_BLOB_SIZE(bundleCount);
+  #endif
+  putInt32(p, blobLen);
+  argsOffset[channel] = (p - datagram) + 4;
+  datagramLen[channel] = argsOffset[channel] + OSC_PAD4(blobLen);
+  #else
+  p[0] = ',';
+  for (int i = 0; i < bundleCount + 1; i++) {
+    p[1 + i] = 'i';
+  }
+  p += OSC_PAD4(1 + bundleCount + 1 + 1);
+  argsOffset[channel] = p - datagram;
+  datagramLen[channel] = argsOffset[channel] + (bundleCount + 1) * 4;
+  #endif
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void setupOSCOut() {
+  // Runtime bundle-size override, if any (never above BUNDLE_SIZE)
+  bundleCount = rcBundleSize();
+
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    renderPPGTemplate(c);
+
+    // Beat event template: "/beat/N" + ",iiii" + 4 int32 args
+    uint8_t* p = beatDatagrams[c];
+    memset(p, 0, OSC_BEAT_MAX);
+    char address[OSC_ADDR_MAX];
+    int addrLen = snprintf(address, sizeof(address), "/beat/%d", PPG_ID + c);
+    memcpy(p, address, addrLen);
+    p += OSC_PAD4(addrLen + 1);
+    memcpy(p, ",iiii", 5);
+    p += OSC_PAD4(5 + 1);
+    beatArgsOffset[c] = p - beatDatagrams[c];
+    beatDatagramLen[c] = beatArgsOffset[c] + 16;
+  }
+}
+
+void oscOutSetBundleSize(int n) {
+  if (n < 1 || n > BUNDLE_SIZE) {
+    return;  // callers validate; clamp defensively anyway
+  }
+  bundleCount = n;
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    renderPPGTemplate(c);
+  }
+}
+
+int oscOutBundleSize() {
+  return bundleCount;
+}
+
+const uint8_t* oscOutRenderBeat(int channel, uint32_t timestampMs,
+                                int32_t ibiMs, int32_t bpm, int32_t amplitude,
+                                size_t* len) {
+  uint8_t* args = beatDatagrams[channel] + beatArgsOffset[channel];
+  putInt32(args, timestampMs);
+  putInt32(args + 4, (uint32_t)ibiMs);
+  putInt32(args + 8, (uint32_t)bpm);
+  putInt32(args + 12, (uint32_t)amplitude);
+  *len = beatDatagramLen[channel];
+  return beatDatagrams[channel];
+}
+
+#ifdef ENABLE_SEQ_RETRANSMIT
+const uint8_t* oscOutRender(int channel, const uint16_t* samples,
+                            uint32_t timestampMs, uint32_t seq, size_t* len) {
+#else
+const uint8_t* oscOutRender(int channel, const uint16_t* samples,
+                            uint32_t timestampMs, size_t* len) {
+#endif
+  uint8_t* args = datagrams[channel] + argsOffset[channel];
+
+  #if defined(ENABLE_SEQ_RETRANSMIT)
+  ppgWirePackSeq(args, samples, bundleCount, timestampMs, seq);
+  #elif defined(ENABLE_PACKED_BUNDLES)
+  ppgWirePack(args, samples, bundleCount, timestampMs);
+  #else
+  for (int i = 0; i < bundleCount; i++) {
+    putInt32(args + i * 4, samples[i]);
+  }
+  putInt32(args + bundleCount * 4, timestampMs);
+  #endif
+
+  *len = datagramLen[channel];
+  return datagrams[channel];
+}
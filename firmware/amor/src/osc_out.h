@@ -0,0 +1,57 @@
+/*
+ * Amor ESP32 Firmware - Zero-allocation OSC bundle serializer
+ *
+ * The CNMAT OSCMessage path allocates on every add() and serializes byte by
+ * byte — at 10Hz forever, which we have traced to heap fragmentation on
+ * long-running units. Since PPG_ID and BUNDLE_SIZE are compile-time
+ * constants, the constant portion of the datagram (address, type tags, blob
+ * size) never changes. setupOSCOut() renders it once at boot into a static
+ * buffer; oscOutRender() then just patches the sample bytes and timestamp
+ * into the fixed offsets. No heap activity in steady state.
+ *
+ * The rendered datagram is identical on the wire to what the OSCMessage
+ * path produced, in both classic (int32 per sample) and packed-blob
+ * (ENABLE_PACKED_BUNDLES) formats.
+ */
+
+#ifndef OSC_OUT_H
+#define OSC_OUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../include/config.h"
+
+// Render the constant portion of the /ppg/N datagram. Call once from setup()
+// (after setupRuntimeConfig(), so a persisted bundle size is honored).
+void setupOSCOut();
+
+// Re-render the /ppg/N template for n samples per bundle (1..BUNDLE_SIZE).
+// Used by the runtime config path; out-of-range values are ignored.
+void oscOutSetBundleSize(int n);
+
+// Samples per bundle the template is currently rendered for.
+int oscOutBundleSize();
+
+// Patch the samples and timestamp into channel's template and return a
+// pointer to the complete datagram; *len receives its size. Channel c is
+// addressed as /ppg/{PPG_ID+c} (multi-channel boards occupy a contiguous
+// id range, so downstream consumers need no protocol change). The buffer
+// is static and is overwritten on the next call for the same channel.
+// With ENABLE_SEQ_RETRANSMIT the caller supplies the transmit sequence
+// number, which rides in the version-2 blob header (see wire.h) — resends
+// pass the original seq so the receiver can close its gap accounting.
+#ifdef ENABLE_SEQ_RETRANSMIT
+const uint8_t* oscOutRender(int channel, const uint16_t* samples,
+                            uint32_t timestampMs, uint32_t seq, size_t* len);
+#else
+const uint8_t* oscOutRender(int channel, const uint16_t* samples,
+                            uint32_t timestampMs, size_t* len);
+#endif
+
+// Render a /beat/{PPG_ID+c} event (timestamp, IBI ms, BPM, pulse amplitude)
+// into its own static template. Same zero-allocation scheme as the bundles.
+const uint8_t* oscOutRenderBeat(int channel, uint32_t timestampMs,
+                                int32_t ibiMs, int32_t bpm, int32_t amplitude,
+                                size_t* len);
+
+#endif // OSC_OUT_H
@@ -0,0 +1,142 @@
+#include "../include/config.h"
+
+#ifdef ENABLE_OTA_UPDATE
+
+#include <Arduino.h>
+#include <Update.h>
+#include <esp_ota_ops.h>
+#include "ota_update.h"
+
+// Only the network task touches the transfer state (the admin listener
+// runs there), so no locking is needed.
+static bool active = false;
+static int expectedIndex = 0;
+static size_t totalSize = 0;
+static size_t received = 0;
+static unsigned long lastChunkMs = 0;
+
+bool otaActive() {
+  return active;
+}
+
+bool otaBegin(size_t size, const char* md5) {
+  if (active) {
+    // Sender restarted the transfer; discard the partial image
+    otaAbort("superseded by new /ota/begin");
+  }
+
+  if (size == 0 || !Update.begin(size, U_FLASH)) {
+    Serial.print("OTA: begin failed: ");
+    Serial.println(Update.errorString());
+    return false;
+  }
+  if (md5 != NULL && md5[0] != '\0' && !Update.setMD5(md5)) {
+    Serial.println("OTA: rejected malformed MD5");
+    Update.abort();
+    return false;
+  }
+
+  active = true;
+  expectedIndex = 0;
+  totalSize = size;
+  received = 0;
+  lastChunkMs = millis();
+
+  Serial.print("OTA: receiving ");
+  Serial.print((unsigned long)size);
+  Serial.println(" bytes into the inactive partition");
+  return true;
+}
+
+int otaWriteChunk(int index, const uint8_t* data, size_t len) {
+  if (!active) {
+    return -1;
+  }
+  lastChunkMs = millis();
+
+  if (index == expectedIndex - 1) {
+    // Duplicate: our ack was lost and the sender retried. Already written.
+    return index;
+  }
+  if (index != expectedIndex || len == 0 || len > OTA_CHUNK_MAX) {
+    otaAbort("chunk out of sequence");
+    return -1;
+  }
+
+  if (Update.write((uint8_t*)data, len) != len) {
+    otaAbort(Update.errorString());
+    return -1;
+  }
+
+  // Progress at each quarter, not per chunk (serial is slow)
+  size_t before = received;
+  received += len;
+  if (received * 4 / totalSize != before * 4 / totalSize) {
+    Serial.print("OTA: ");
+    Serial.print((unsigned long)(received * 100 / totalSize));
+    Serial.println("%");
+  }
+
+  expectedIndex++;
+  return index;
+}
+
+bool otaFinish() {
+  if (!active) {
+    return false;
+  }
+  active = false;
+
+  if (!Update.end() || !Update.isFinished()) {
+    Serial.print("OTA: verification failed: ");
+    Serial.println(Update.errorString());
+    return false;
+  }
+
+  Serial.println("OTA: image verified, boot partition switched");
+  return true;
+}
+
+void otaAbort(const char* reason) {
+  if (!active) {
+    return;
+  }
+  active = false;
+  Update.abort();
+
+  Serial.print("OTA: aborted (");
+  Serial.print(reason);
+  Serial.print(") after ");
+  Serial.print((unsigned long)received);
+  Serial.println(" bytes");
+}
+
+void otaTick() {
+  if (active && millis() - lastChunkMs > OTA_TIMEOUT_MS) {
+    otaAbort("transfer timed out");
+  }
+}
+
+bool otaRollback() {
+  if (!Update.canRollBack()) {
+    Serial.println("OTA: no previous image to roll back to");
+    return false;
+  }
+  return Update.rollBack();
+}
+
+void otaMarkValid() {
+  // With CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE an updated image boots in
+  // pending-verify state and reverts on the next reset unless confirmed;
+  // WiFi coming up is our health check. The stock Arduino core ships
+  // without that option, where this is a harmless no-op and /ota/rollback
+  // stays the manual recovery path.
+  static bool marked = false;
+  if (marked) {
+    return;
+  }
+  marked = true;
+  esp_ota_mark_app_valid_cancel_rollback();
+}
+
+#endif // ENABLE_OTA_UPDATE
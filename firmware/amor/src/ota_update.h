@@ -0,0 +1,69 @@
+/*
+ * Amor ESP32 Firmware - OTA updates over the OSC admin channel
+ *
+ * The units are sealed into costumes; reflashing one means extracting it
+ * and running the per-unit PlatformIO upload target, so in practice fixes
+ * never ship mid-event. This module drives the Arduino Update library
+ * (inactive app partition, dual-slot default.csv layout on the S3) from
+ * the existing admin listener instead:
+ *
+ *   /ota/begin [size (int32), md5 (string)]   enter receive mode
+ *   /ota/data  [index (int32), chunk (blob)]  sequential chunks, each acked
+ *   /ota/end                                  verify MD5, switch slots, reboot
+ *   /ota/abort                                discard and resume normal op
+ *   /ota/rollback                             boot the previous image
+ *
+ * The sender (testing/ota_update.py) waits for each /ota/ack before the
+ * next chunk, so chunks arrive in order and a lost datagram just costs a
+ * retry. A stalled transfer times out and the unit resumes normal
+ * operation. Sampling keeps running during the transfer; flash writes
+ * delay individual ticks but the grid catches up.
+ */
+
+#ifndef OTA_UPDATE_H
+#define OTA_UPDATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest chunk payload the admin listener can carry: MAX_OSC_MESSAGE_SIZE
+// minus the /ota/data address, tags, index and blob framing.
+#define OTA_CHUNK_MAX 400
+
+// Abort the transfer and resume normal operation if no chunk arrives for
+// this long (sender crashed, WiFi died mid-transfer).
+#define OTA_TIMEOUT_MS 30000
+
+// A transfer is in progress: the network task polls the admin socket
+// every iteration instead of on the 3-second cadence.
+bool otaActive();
+
+// Start receiving `size` bytes into the inactive app partition. The MD5
+// (hex string) is verified before the boot partition is switched.
+bool otaBegin(size_t size, const char* md5);
+
+// Write one chunk. Chunks must arrive in order; the previous index is
+// re-acked without writing (its ack was lost). Returns the index to ack,
+// or -1 when the transfer was aborted (bad order, flash error).
+int otaWriteChunk(int index, const uint8_t* data, size_t len);
+
+// Finalize: verify the image and set it as the boot partition. The caller
+// reboots on success.
+bool otaFinish();
+
+// Discard a transfer in progress and resume normal operation.
+void otaAbort(const char* reason);
+
+// Timeout watchdog; call periodically while a transfer is active.
+void otaTick();
+
+// Re-select the previous app partition for boot (manual recovery from a
+// bad-but-bootable image). The caller reboots on true.
+bool otaRollback();
+
+// Confirm the running image once WiFi is up after an update boot. With a
+// rollback-enabled bootloader this cancels the automatic revert; on the
+// stock Arduino core it is a no-op and /ota/rollback is the manual path.
+void otaMarkValid();
+
+#endif // OTA_UPDATE_H
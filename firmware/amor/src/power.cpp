@@ -0,0 +1,59 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include "power.h"
+#include "../include/config.h"
+
+#ifdef ENABLE_LIGHT_SLEEP
+
+#include "esp_pm.h"
+
+// DFS bounds (MHz). Max defaults to the configured CPU clock; the chip can
+// drop to min whenever nothing is runnable.
+#ifndef PM_CPU_FREQ_MAX_MHZ
+#define PM_CPU_FREQ_MAX_MHZ (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+#endif
+#ifndef PM_CPU_FREQ_MIN_MHZ
+#define PM_CPU_FREQ_MIN_MHZ 40
+#endif
+
+void setupPower() {
+  #if CONFIG_IDF_TARGET_ESP32
+  esp_pm_config_esp32_t pmConfig;
+  #elif CONFIG_IDF_TARGET_ESP32S3
+  esp_pm_config_esp32s3_t pmConfig;
+  #else
+  #error "Light sleep: unsupported target, add its esp_pm config type"
+  #endif
+
+  pmConfig.max_freq_mhz = PM_CPU_FREQ_MAX_MHZ;
+  pmConfig.min_freq_mhz = PM_CPU_FREQ_MIN_MHZ;
+  pmConfig.light_sleep_enable = true;
+
+  esp_err_t err = esp_pm_configure(&pmConfig);
+  if (err == ESP_OK) {
+    Serial.print("Power: automatic light sleep enabled (");
+    Serial.print(PM_CPU_FREQ_MIN_MHZ);
+    Serial.print("-");
+    Serial.print(PM_CPU_FREQ_MAX_MHZ);
+    Serial.println("MHz DFS)");
+  } else {
+    // ESP_ERR_NOT_SUPPORTED: core built without CONFIG_PM_ENABLE
+    Serial.print("WARNING: esp_pm_configure failed (");
+    Serial.print(err);
+    Serial.println("), falling back to modem sleep only");
+  }
+
+  // Radio wakes only for DTIM beacons; costs at most one DTIM interval of
+  // latency on sends
+  WiFi.setSleep(WIFI_PS_MAX_MODEM);
+  Serial.println("Power: WiFi max modem sleep (DTIM) enabled");
+}
+
+#else
+
+void setupPower() {
+  // Light sleep disabled: keep the radio responsive
+  WiFi.setSleep(WIFI_PS_NONE);
+}
+
+#endif // ENABLE_LIGHT_SLEEP
@@ -0,0 +1,31 @@
+/*
+ * Amor ESP32 Firmware - Light-sleep power scheduler
+ *
+ * Without this, the ~19ms of dead time per 20ms grid slot is spent in
+ * delay()/vTaskDelay(), which yields to FreeRTOS but keeps the CPU and
+ * radio fully powered — far above the budget in
+ * docs/firmware-power-management.md for the battery units.
+ *
+ * ENABLE_LIGHT_SLEEP turns on:
+ *   - automatic light sleep via esp_pm (tickless idle drops into light
+ *     sleep between task wakeups, with DFS between PM_CPU_FREQ_MIN/MAX)
+ *   - WiFi max modem sleep, so the radio wakes only for DTIM beacons
+ *
+ * The sampling engine switches to an esp_timer clock source in this mode
+ * (see sampler.cpp): the general-purpose hardware timers freeze during
+ * light sleep, while esp_timer is a wake source, so no grid slot is
+ * missed. Bundle sends ride the existing path and are delayed by at most
+ * one DTIM interval by modem sleep.
+ *
+ * esp_pm requires a core built with CONFIG_PM_ENABLE; if it isn't,
+ * setupPower() logs the error and falls back to modem sleep only.
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+// Configure automatic light sleep and WiFi modem sleep.
+// Call after setupWiFi() so the power-save mode applies to the live link.
+void setupPower();
+
+#endif // POWER_H
@@ -0,0 +1,127 @@
+#include "quality_gate.h"
+
+#ifdef ENABLE_QUALITY_GATE
+
+#include <stream_stats.h>
+#include "runtime_config.h"
+#include "telemetry_log.h"
+
+#ifndef PPG_NUM_CHANNELS
+#define PPG_NUM_CHANNELS 1
+#endif
+
+// Per-channel classifier state. The stats window is one second at the
+// wire rate — long enough that a quiet diastole doesn't read as flat,
+// short enough that the stddev tracks a removed finger within a second.
+struct ChannelGate {
+  StreamStats stats{SAMPLE_RATE_HZ};
+  QualityState state = QG_ACTIVE;
+  bool outOfBand = false;         // Evidence accumulating toward gating
+  uint32_t outOfBandSinceMs = 0;
+  bool inBand = false;            // Evidence accumulating toward noisy exit
+  uint32_t inBandSinceMs = 0;
+  uint32_t lastKeepaliveMs = 0;
+};
+
+static ChannelGate gates[PPG_NUM_CHANNELS];
+static uint32_t suppressedCount = 0;
+
+static void setState(ChannelGate& gate, int channel, QualityState next,
+                     uint32_t timestampMs) {
+  gate.state = next;
+  gate.outOfBand = false;
+  gate.inBand = false;
+  gate.lastKeepaliveMs = timestampMs;  // gated states start with a fresh keepalive clock
+  TLOG_INFO(TLOG_EVT_QG_STATE, (int32_t)channel, (int32_t)next);
+}
+
+bool qualityGateAdmit(int channel, const uint16_t* samples, int count,
+                      uint32_t timestampMs) {
+  ChannelGate& gate = gates[channel];
+
+  uint16_t lo = samples[0];
+  uint16_t hi = samples[0];
+  for (int i = 0; i < count; i++) {
+    gate.stats.addSample(samples[i]);
+    if (samples[i] < lo) lo = samples[i];
+    if (samples[i] > hi) hi = samples[i];
+  }
+
+  // Don't classify until the window is full: the first second after boot
+  // (or a reset) always streams
+  if (gate.stats.count() < (int)rcSampleRateHz()) {
+    return true;
+  }
+  uint16_t sd = gate.stats.stddev();
+
+  switch (gate.state) {
+    case QG_ACTIVE:
+      if (sd < QG_FLAT_STDDEV || sd > QG_NOISY_STDDEV) {
+        if (!gate.outOfBand) {
+          gate.outOfBand = true;
+          gate.outOfBandSinceMs = timestampMs;
+        } else if (timestampMs - gate.outOfBandSinceMs >= QG_FLAT_HOLD_MS) {
+          setState(gate, channel,
+                   (sd < QG_FLAT_STDDEV) ? QG_FLAT : QG_NOISY, timestampMs);
+          break;  // first gated bundle falls through to the keepalive check
+        }
+      } else {
+        gate.outOfBand = false;
+      }
+      return true;
+
+    case QG_FLAT:
+      // Any real excursion in this very bundle resumes streaming now —
+      // the whole round trip from touch to full rate is one bundle
+      // interval
+      if ((uint16_t)(hi - lo) >= QG_WAKE_DELTA) {
+        setState(gate, channel, QG_ACTIVE, timestampMs);
+        return true;
+      }
+      break;
+
+    case QG_NOISY:
+      // Noise has spread, so the wake-delta shortcut can't apply; exit
+      // needs the stddev back in the pulse band for a full window. (A
+      // lead that goes from noisy straight to flat stays gated, just
+      // under the noisy label.)
+      if (sd >= QG_FLAT_STDDEV && sd <= QG_NOISY_STDDEV) {
+        if (!gate.inBand) {
+          gate.inBand = true;
+          gate.inBandSinceMs = timestampMs;
+        } else if (timestampMs - gate.inBandSinceMs >= QG_KEEPALIVE_MS) {
+          setState(gate, channel, QG_ACTIVE, timestampMs);
+          return true;
+        }
+      } else {
+        gate.inBand = false;
+      }
+      break;
+  }
+
+  // Gated: one keepalive bundle per second keeps the unit (and its
+  // signal) visible to the server; everything else is suppressed
+  if (timestampMs - gate.lastKeepaliveMs >= QG_KEEPALIVE_MS) {
+    gate.lastKeepaliveMs = timestampMs;
+    return true;
+  }
+  suppressedCount++;
+  return false;
+}
+
+QualityState qualityGateState(int channel) {
+  return gates[channel].state;
+}
+
+uint32_t qualityGateSuppressedCount() {
+  return suppressedCount;
+}
+
+void qualityGateReset() {
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    gates[c] = ChannelGate();
+    gates[c].stats.reset((int)rcSampleRateHz());
+  }
+}
+
+#endif // ENABLE_QUALITY_GATE
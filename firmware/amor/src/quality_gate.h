@@ -0,0 +1,73 @@
+/*
+ * Amor ESP32 Firmware - Signal-quality-gated transmission
+ *
+ * A unit whose sensor isn't on a body streams a flat line at full rate all
+ * night, spending airtime and battery the worn units need. This gate
+ * classifies each channel from the variance the streaming-statistics
+ * engine maintains — active (plausible pulse), flat (no contact), noisy
+ * (dangling lead, motion) — and while the signal is flat or noisy admits
+ * only one keepalive bundle per second, so the server still sees the unit
+ * and its signal but the radio goes quiet.
+ *
+ * Entering the gated state takes QG_FLAT_HOLD_MS of sustained evidence so
+ * a quiet diastole never pauses a live stream. Leaving it is immediate:
+ * any bundle whose peak-to-peak spread clears QG_WAKE_DELTA (someone
+ * touched the sensor) streams again within one bundle interval. Suppressed
+ * bundles are never sealed, so they consume no sequence numbers and leave
+ * no NACKable holes; they also skip the outage backlog and spool, which a
+ * flat night would otherwise fill.
+ */
+
+#ifndef QUALITY_GATE_H
+#define QUALITY_GATE_H
+
+#include <stdint.h>
+#include "../include/config.h"
+
+// Classification thresholds on the 1-second stddev of the (conditioned)
+// 12-bit signal. A worn sensor at rest sits well above QG_FLAT_STDDEV; an
+// open lead picking up noise sits above QG_NOISY_STDDEV.
+#ifndef QG_FLAT_STDDEV
+#define QG_FLAT_STDDEV 8
+#endif
+#ifndef QG_NOISY_STDDEV
+#define QG_NOISY_STDDEV 700
+#endif
+
+// Peak-to-peak spread within one bundle that wakes a flat channel.
+#ifndef QG_WAKE_DELTA
+#define QG_WAKE_DELTA 50
+#endif
+
+// Sustained out-of-band time before a channel is gated (flat or noisy),
+// and the keepalive cadence while it is.
+#ifndef QG_FLAT_HOLD_MS
+#define QG_FLAT_HOLD_MS 5000
+#endif
+#ifndef QG_KEEPALIVE_MS
+#define QG_KEEPALIVE_MS 1000
+#endif
+
+enum QualityState : uint8_t {
+  QG_ACTIVE = 0,
+  QG_FLAT = 1,
+  QG_NOISY = 2,
+};
+
+// Account one sealed-but-not-yet-sent bundle and decide whether to
+// transmit it. Returns true to stream, false to suppress (the per-second
+// keepalive returns true even while gated). timestampMs is the bundle's
+// grid time.
+bool qualityGateAdmit(int channel, const uint16_t* samples, int count,
+                      uint32_t timestampMs);
+
+// Current classification of one channel.
+QualityState qualityGateState(int channel);
+
+// Bundles suppressed across all channels since boot.
+uint32_t qualityGateSuppressedCount();
+
+// Forget everything (e.g. after a sample-rate change re-grids the signal).
+void qualityGateReset();
+
+#endif // QUALITY_GATE_H
@@ -0,0 +1,44 @@
+#include <string.h>
+#include "retransmit.h"
+
+#ifdef ENABLE_SEQ_RETRANSMIT
+
+// Only the sender task touches the history in steady state (it records
+// transmits and resolves queued resend requests); the network task calls
+// retransmitReset() only after quiescing the transmit queue, so no
+// locking is needed. `valid` distinguishes never-written slots from seq 0
+// after boot.
+struct HistorySlot {
+  bool valid;
+  uint32_t seq;
+  BundleRecord bundle;
+};
+
+static HistorySlot ring[RETRANSMIT_HISTORY_BUNDLES] = {};
+
+void retransmitRemember(uint32_t seq, int channel, const uint16_t* samples,
+                        uint32_t timestampMs) {
+  HistorySlot& slot = ring[seq % RETRANSMIT_HISTORY_BUNDLES];
+  slot.valid = true;
+  slot.seq = seq;
+  slot.bundle.timestampMs = timestampMs;
+  slot.bundle.channel = (uint8_t)channel;
+  memcpy(slot.bundle.samples, samples, sizeof(slot.bundle.samples));
+}
+
+bool retransmitLookup(uint32_t seq, BundleRecord* out) {
+  const HistorySlot& slot = ring[seq % RETRANSMIT_HISTORY_BUNDLES];
+  if (!slot.valid || slot.seq != seq) {
+    return false;
+  }
+  *out = slot.bundle;
+  return true;
+}
+
+void retransmitReset() {
+  for (int i = 0; i < RETRANSMIT_HISTORY_BUNDLES; i++) {
+    ring[i].valid = false;
+  }
+}
+
+#endif // ENABLE_SEQ_RETRANSMIT
@@ -0,0 +1,44 @@
+/*
+ * Amor ESP32 Firmware - Sent-bundle history for NACK retransmits
+ *
+ * The outage backlog (backlog.h) covers the WiFi-down case, but a bundle
+ * the firmware believes it sent can still die on the air or in a switch
+ * queue — UDP gives no signal either way. With ENABLE_SEQ_RETRANSMIT every
+ * bundle carries a monotonic sequence number (version-2 blob header, see
+ * wire.h); this ring keeps the last RETRANSMIT_HISTORY_BUNDLES of them as
+ * sent, so when the server NACKs a missing seq on the admin channel the
+ * exact original datagram can go out again.
+ *
+ * Slotting is seq % capacity: seqs are assigned densely at transmit time,
+ * so a lookup is one index plus a seq compare — no search, nothing the
+ * hot path has to scan.
+ */
+
+#ifndef RETRANSMIT_H
+#define RETRANSMIT_H
+
+#include <stdint.h>
+#include "backlog.h"
+
+// History depth in bundles. The default covers ~6 seconds at the stock
+// 10Hz bundle rate (~1.5KB of RAM); NACKs for anything older miss, which
+// is fine — the server stops chasing holes that far back.
+#ifndef RETRANSMIT_HISTORY_BUNDLES
+#define RETRANSMIT_HISTORY_BUNDLES 64
+#endif
+
+// Record a just-transmitted bundle under its sequence number. The
+// timestamp should be the wire timestamp (post clock-sync conversion) so
+// a resend reproduces the original datagram byte for byte.
+void retransmitRemember(uint32_t seq, int channel, const uint16_t* samples,
+                        uint32_t timestampMs);
+
+// Fetch the bundle sent as `seq`. Returns false if it has already been
+// overwritten (aged out of the ring) or was never sent.
+bool retransmitLookup(uint32_t seq, BundleRecord* out);
+
+// Drop all history. Called when a runtime config change re-shapes the
+// bundle layout, so stale records can't be resent under the new framing.
+void retransmitReset();
+
+#endif // RETRANSMIT_H
@@ -0,0 +1,103 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include "runtime_config.h"
+#include "sampler.h"
+#include "osc_out.h"
+#include "../include/config.h"
+
+#ifdef ENABLE_RUNTIME_CONFIG
+
+#include <Preferences.h>
+
+// NVS namespace and keys
+#define RC_NAMESPACE "amor"
+#define RC_KEY_RATE "rate"
+#define RC_KEY_BUNDLE "bundle"
+#define RC_KEY_TXPOWER "txpower"
+#define RC_KEY_MODE "mode"
+
+// Validation bounds
+#define RC_RATE_MIN 10
+#define RC_RATE_MAX 500
+#define RC_TXPOWER_MIN 8    // WIFI_POWER_2dBm
+#define RC_TXPOWER_MAX 84   // WIFI_POWER_19_5dBm
+
+static Preferences prefs;
+
+static uint32_t sampleRateHz = SAMPLE_RATE_HZ;
+static int bundleSize = BUNDLE_SIZE;
+static int txPowerQdbm = (int)WIFI_POWER_5dBm;
+static int mode = RC_MODE_DEFAULT;
+
+void setupRuntimeConfig() {
+  prefs.begin(RC_NAMESPACE, false);
+  sampleRateHz = prefs.getUInt(RC_KEY_RATE, SAMPLE_RATE_HZ);
+  bundleSize = prefs.getInt(RC_KEY_BUNDLE, BUNDLE_SIZE);
+  txPowerQdbm = prefs.getInt(RC_KEY_TXPOWER, (int)WIFI_POWER_5dBm);
+  mode = prefs.getInt(RC_KEY_MODE, RC_MODE_DEFAULT);
+
+  Serial.print("Runtime config: rate=");
+  Serial.print(sampleRateHz);
+  Serial.print("Hz bundle=");
+  Serial.print(bundleSize);
+  Serial.print(" txpower=");
+  Serial.print(txPowerQdbm * 0.25f);
+  Serial.print("dBm mode=");
+  Serial.println(mode);
+}
+
+uint32_t rcSampleRateHz() { return sampleRateHz; }
+uint32_t rcSampleIntervalMs() { return 1000 / sampleRateHz; }
+int rcBundleSize() { return bundleSize; }
+int rcTxPowerQdbm() { return txPowerQdbm; }
+int rcMode() { return mode; }
+
+bool rcSetSampleRateHz(uint32_t hz) {
+  if (hz < RC_RATE_MIN || hz > RC_RATE_MAX || 1000 % hz != 0) {
+    return false;  // interval must be a whole number of ms
+  }
+  sampleRateHz = hz;
+  prefs.putUInt(RC_KEY_RATE, hz);
+
+  // DMA/oversampled capture can't re-clock live; then NVS applies at boot
+  if (!samplerSetRateHz(hz)) {
+    Serial.println("Config: rate persisted, applies after reboot (capture mode is fixed-rate)");
+  }
+  return true;
+}
+
+bool rcSetBundleSize(int n) {
+  if (n < 1 || n > BUNDLE_SIZE) {
+    return false;  // buffers are sized for the compile-time maximum
+  }
+  bundleSize = n;
+  prefs.putInt(RC_KEY_BUNDLE, n);
+  oscOutSetBundleSize(n);
+  return true;
+}
+
+bool rcSetTxPowerQdbm(int qdbm) {
+  if (qdbm < RC_TXPOWER_MIN || qdbm > RC_TXPOWER_MAX) {
+    return false;
+  }
+  txPowerQdbm = qdbm;
+  prefs.putInt(RC_KEY_TXPOWER, qdbm);
+  WiFi.setTxPower((wifi_power_t)qdbm);
+  return true;
+}
+
+bool rcSetMode(int newMode) {
+  if (newMode < RC_MODE_RAW || newMode > RC_MODE_BOTH) {
+    return false;
+  }
+  #ifndef ENABLE_BEAT_DETECTOR
+  if (newMode != RC_MODE_RAW) {
+    return false;  // beat modes need the detector compiled in
+  }
+  #endif
+  mode = newMode;
+  prefs.putInt(RC_KEY_MODE, newMode);
+  return true;
+}
+
+#endif // ENABLE_RUNTIME_CONFIG
@@ -0,0 +1,74 @@
+/*
+ * Amor ESP32 Firmware - Runtime-tunable capture parameters
+ *
+ * Tuning SAMPLE_RATE_HZ, BUNDLE_SIZE or TX power used to mean a config.h
+ * edit and a reflash of all four env:esp32s3-idN targets — an hour of
+ * iteration for what should be seconds during a live installation. With
+ * ENABLE_RUNTIME_CONFIG the admin channel accepts:
+ *
+ *   /config/rate    [hz]       sample rate (timer-clocked capture only)
+ *   /config/bundle  [n]        samples per bundle, 1..BUNDLE_SIZE_MAX
+ *   /config/txpower [qdbm]     WiFi TX power in quarter-dBm (8..84)
+ *   /config/mode    [0|1|2]    0 = raw stream, 1 = beat events, 2 = both
+ *
+ * Values are validated, applied immediately without reboot, and persisted
+ * to NVS so they survive resets. config.h values remain the defaults for
+ * anything never overridden.
+ *
+ * BUNDLE_SIZE from config.h becomes the compile-time maximum (buffers are
+ * sized for it); the runtime value can only shrink it.
+ */
+
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <stdint.h>
+#include "../include/config.h"
+
+// Transmit mode values for rcMode()
+#define RC_MODE_RAW 0
+#define RC_MODE_BEATS 1
+#define RC_MODE_BOTH 2
+
+// Default mode from the compile-time feature flags
+#if defined(BEAT_EVENTS_ONLY)
+#define RC_MODE_DEFAULT RC_MODE_BEATS
+#elif defined(ENABLE_BEAT_DETECTOR)
+#define RC_MODE_DEFAULT RC_MODE_BOTH
+#else
+#define RC_MODE_DEFAULT RC_MODE_RAW
+#endif
+
+#ifdef ENABLE_RUNTIME_CONFIG
+
+// Load persisted overrides from NVS (falling back to config.h defaults).
+// Call early in setup(), before the sampler and OSC template are set up.
+void setupRuntimeConfig();
+
+// Current values.
+uint32_t rcSampleRateHz();
+uint32_t rcSampleIntervalMs();
+int rcBundleSize();
+int rcTxPowerQdbm();
+int rcMode();
+
+// Setters: validate, persist to NVS, and apply live where possible.
+// Return false (and change nothing) on out-of-range values.
+bool rcSetSampleRateHz(uint32_t hz);
+bool rcSetBundleSize(int n);
+bool rcSetTxPowerQdbm(int qdbm);
+bool rcSetMode(int mode);
+
+#else
+
+// Without the feature, the getters collapse to the config.h constants so
+// callers never need their own #ifdefs.
+inline void setupRuntimeConfig() {}
+inline uint32_t rcSampleRateHz() { return SAMPLE_RATE_HZ; }
+inline uint32_t rcSampleIntervalMs() { return SAMPLE_INTERVAL_MS; }
+inline int rcBundleSize() { return BUNDLE_SIZE; }
+inline int rcMode() { return RC_MODE_DEFAULT; }
+
+#endif // ENABLE_RUNTIME_CONFIG
+
+#endif // RUNTIME_CONFIG_H
@@ -0,0 +1,501 @@
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sampler.h"
+#include "timing_stats.h"
+#include "runtime_config.h"
+#include "../include/config.h"
+
+#ifdef ENABLE_ADC_DMA
+#include "driver/adc.h"
+#endif
+
+#ifdef ENABLE_LIGHT_SLEEP
+#include "esp_timer.h"
+#endif
+
+// Sensors multiplexed on this board (separate ADC1 pins, shared grid)
+#ifndef PPG_NUM_CHANNELS
+#define PPG_NUM_CHANNELS 1
+#endif
+
+#ifdef ENABLE_OVERSAMPLING
+#include <decimator.h>
+
+// Capture rate for the oversampled path; decimated to SAMPLE_RATE_HZ
+#ifndef OVERSAMPLE_RATE_HZ
+#define OVERSAMPLE_RATE_HZ 500
+#endif
+#define OVERSAMPLE_FACTOR (OVERSAMPLE_RATE_HZ / SAMPLE_RATE_HZ)
+
+// Anti-aliasing FIR + decimation from OVERSAMPLE_RATE_HZ down to the grid,
+// one filter state per channel
+static Decimator decimators[PPG_NUM_CHANNELS] = {
+  Decimator(OVERSAMPLE_FACTOR),
+  #if PPG_NUM_CHANNELS >= 2
+  Decimator(OVERSAMPLE_FACTOR),
+  #endif
+  #if PPG_NUM_CHANNELS >= 3
+  Decimator(OVERSAMPLE_FACTOR),
+  #endif
+  #if PPG_NUM_CHANNELS >= 4
+  Decimator(OVERSAMPLE_FACTOR),
+  #endif
+};
+#endif
+
+// ADC1 pins per channel; PPG_GPIO stays the name for channel 0 so existing
+// configs keep working. Up to four channels (ADC1 has 6-8 usable pins).
+static const uint8_t ppgPins[PPG_NUM_CHANNELS] = {
+  PPG_GPIO,
+  #if PPG_NUM_CHANNELS >= 2
+  PPG_GPIO_2,
+  #endif
+  #if PPG_NUM_CHANNELS >= 3
+  PPG_GPIO_3,
+  #endif
+  #if PPG_NUM_CHANNELS >= 4
+  PPG_GPIO_4,
+  #endif
+};
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+// Ring capacity in samples. Power of two so index wrap is a mask.
+// 64 samples = 1.28s of headroom at 50Hz before overrun.
+#define SAMPLER_RING_SIZE 64
+#define SAMPLER_RING_MASK (SAMPLER_RING_SIZE - 1)
+
+// Sampling task gets the highest priority so the ISR-to-read latency is
+// bounded by the scheduler, not by whatever else is running.
+#define SAMPLER_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+#define SAMPLER_TASK_STACK 2048
+
+// Pin sampling away from the core running WiFi/lwIP (core 0 on ESP32) so a
+// busy radio can never delay a conversion. Overridable from config.h.
+#ifndef SAMPLING_CORE
+#define SAMPLING_CORE 1
+#endif
+
+// ============================================================================
+// State
+// ============================================================================
+
+// Single-producer (sampling task) / single-consumer (loop) ring.
+// head is written only by the producer, tail only by the consumer.
+static TimedSample ring[SAMPLER_RING_SIZE];
+static volatile uint32_t ringHead = 0;
+static volatile uint32_t ringTail = 0;
+
+#if !defined(ENABLE_ADC_DMA) && !defined(ENABLE_LIGHT_SLEEP)
+static hw_timer_t* sampleTimer = NULL;
+#endif
+#if defined(ENABLE_ADC_DMA) && defined(ENABLE_LIGHT_SLEEP)
+#error "ENABLE_ADC_DMA and ENABLE_LIGHT_SLEEP are incompatible: the ADC digital controller stalls during light sleep"
+#endif
+static TaskHandle_t samplerTask = NULL;
+
+static unsigned long gridBaseMs = 0;
+static volatile uint32_t tickCount = 0;
+static volatile uint32_t overrunCount = 0;
+
+// Push one 50Hz grid sample into the SPSC ring (producer side only).
+static void pushSample(uint16_t sample, uint8_t channel, uint32_t gridIndex) {
+  uint32_t head = ringHead;
+  uint32_t next = (head + 1) & SAMPLER_RING_MASK;
+  if (next == ringTail) {
+    // Consumer fell behind; drop this grid slot rather than block.
+    overrunCount++;
+  } else {
+    ring[head].value = sample;
+    ring[head].channel = channel;
+    ring[head].gridIndex = gridIndex;
+    ringHead = next;
+  }
+}
+
+// Rate the capture hardware actually runs at; outputs land on the 50Hz grid
+// either directly or through the decimator.
+#ifdef ENABLE_OVERSAMPLING
+#define SAMPLER_CAPTURE_RATE_HZ OVERSAMPLE_RATE_HZ
+#else
+#define SAMPLER_CAPTURE_RATE_HZ SAMPLE_RATE_HZ
+#endif
+
+// Live capture rate; only diverges from the macro via samplerSetRateHz()
+// in the timer-clocked modes.
+static volatile uint32_t captureRateHz = SAMPLER_CAPTURE_RATE_HZ;
+
+// Set when the grid is re-based; the sampling task restarts its index.
+static volatile bool gridResetPending = false;
+
+// Producer-side: route one raw conversion toward the 50Hz grid. Returns
+// true when a sample landed on the grid (so the caller advances its index
+// once per slot, not once per channel).
+static bool feedRawSample(int channel, uint16_t raw, uint32_t gridIndex) {
+  #ifdef ENABLE_OVERSAMPLING
+  uint16_t filtered;
+  // All channel decimators share factor and phase, so in any given tick
+  // either every channel produces an output or none does
+  if (decimators[channel].processSample(raw, &filtered)) {
+    pushSample(filtered, (uint8_t)channel, gridIndex);
+    return true;
+  }
+  return false;
+  #else
+  pushSample(raw, (uint8_t)channel, gridIndex);
+  return true;
+  #endif
+}
+
+#ifndef ENABLE_ADC_DMA
+
+// ============================================================================
+// Timer-ISR Backend (default)
+// ============================================================================
+
+#ifdef ENABLE_TIMING_STATS
+// micros() at tick 0; deviations are measured against this plus the tick
+// count times the period. All arithmetic is modulo 2^32, so the small
+// deviation survives micros() wraparound intact.
+static uint32_t firstTickMicros = 0;
+#endif
+
+// Per-tick bookkeeping shared by both clock sources (safe in ISR context).
+static inline void IRAM_ATTR recordTick() {
+  #ifdef ENABLE_TIMING_STATS
+  uint32_t now = micros();
+  if (tickCount == 0) {
+    firstTickMicros = now;
+  }
+  int32_t deviationUs = (int32_t)((now - firstTickMicros) -
+      tickCount * (1000000UL / captureRateHz));
+  timingStatsRecord(deviationUs);
+  #endif
+
+  tickCount++;
+}
+
+#ifdef ENABLE_LIGHT_SLEEP
+
+// Light-sleep mode clocks the grid from esp_timer: the general-purpose
+// hardware timers freeze during light sleep, while esp_timer is a wake
+// source. The callback runs in the esp_timer task, not an ISR.
+static esp_timer_handle_t espSampleTimer = NULL;
+
+static void onEspSampleTimer(void* arg) {
+  recordTick();
+  xTaskNotifyGive(samplerTask);
+}
+
+#else
+
+// Timer ISR: count the tick and wake the sampling task. The ADC conversion
+// itself happens in task context because the IDF ADC driver takes locks.
+static void IRAM_ATTR onSampleTimer() {
+  recordTick();
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(samplerTask, &woken);
+  if (woken == pdTRUE) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+#endif // ENABLE_LIGHT_SLEEP
+
+static void samplerTaskLoop(void* arg) {
+  uint32_t gridIndex = 0;
+
+  for (;;) {
+    // Block until the hardware timer fires. ulTaskNotifyTake returns the
+    // number of pending notifications, so missed wakeups are not lost.
+    uint32_t pending = ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+    if (gridResetPending) {
+      gridResetPending = false;
+      gridIndex = 0;
+    }
+
+    while (pending--) {
+      // Interleaved slot: read every channel back-to-back, then advance
+      bool advanced = false;
+      for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+        if (feedRawSample(c, analogRead(ppgPins[c]), gridIndex)) {
+          advanced = true;
+        }
+      }
+      if (advanced) {
+        gridIndex++;
+      }
+    }
+  }
+}
+
+void setupSampler() {
+  #ifndef ENABLE_OVERSAMPLING
+  // Persisted rate override, if any (ENABLE_RUNTIME_CONFIG); the oversampled
+  // path keeps its compile-time capture rate to match the decimator design
+  captureRateHz = rcSampleRateHz();
+  #endif
+
+  xTaskCreatePinnedToCore(samplerTaskLoop, "ppg_sampler", SAMPLER_TASK_STACK,
+                          NULL, SAMPLER_TASK_PRIORITY, &samplerTask,
+                          SAMPLING_CORE);
+
+  #ifdef ENABLE_LIGHT_SLEEP
+  const esp_timer_create_args_t timerArgs = {
+    .callback = &onEspSampleTimer,
+    .arg = NULL,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "ppg_tick",
+  };
+  ESP_ERROR_CHECK(esp_timer_create(&timerArgs, &espSampleTimer));
+  gridBaseMs = millis();
+  ESP_ERROR_CHECK(esp_timer_start_periodic(
+      espSampleTimer, 1000000ULL / captureRateHz));
+  #else
+  // Timer 0, 80MHz APB clock / 80 = 1MHz (1us per tick), count up.
+  sampleTimer = timerBegin(0, 80, true);
+  timerAttachInterrupt(sampleTimer, &onSampleTimer, true);
+  timerAlarmWrite(sampleTimer, 1000000UL / captureRateHz, true);  // auto-reload
+
+  gridBaseMs = millis();
+  timerAlarmEnable(sampleTimer);
+  #endif
+
+  Serial.print("Sampler started: hardware timer at ");
+  Serial.print(captureRateHz);
+  Serial.print("Hz, wire rate ");
+  Serial.print(rcSampleRateHz());
+  Serial.println("Hz");
+}
+
+#else // ENABLE_ADC_DMA
+
+// ============================================================================
+// ADC DMA Backend
+// ============================================================================
+//
+// The ADC digital controller streams conversions into DMA buffers with zero
+// CPU per conversion. Its minimum conversion rate (~611Hz) is above our 50Hz
+// wire rate, so we capture at ADC_DMA_SAMPLE_RATE_HZ and boxcar-average each
+// block of ADC_DMA_DECIMATION conversions into one grid sample. The averaging
+// also buys ~1.5 bits of SNR at the default 1kHz capture rate.
+
+// With oversampling the digital controller runs at the oversample rate and
+// the FIR decimator replaces the boxcar average.
+#ifdef ENABLE_OVERSAMPLING
+#undef ADC_DMA_SAMPLE_RATE_HZ
+#define ADC_DMA_SAMPLE_RATE_HZ OVERSAMPLE_RATE_HZ
+#endif
+
+#define ADC_DMA_DECIMATION (ADC_DMA_SAMPLE_RATE_HZ / SAMPLE_RATE_HZ)
+
+// DMA buffering: read in chunks of one grid slot's worth of conversions
+// (per channel; the controller interleaves channels round-robin).
+#define ADC_DMA_READ_BYTES \
+  (PPG_NUM_CHANNELS * ADC_DMA_DECIMATION * sizeof(adc_digi_output_data_t))
+#define ADC_DMA_BUF_BYTES (4 * ADC_DMA_READ_BYTES)
+
+// ADC1 channel numbers per board channel, matching ppgPins[]
+static const uint8_t ppgAdcChannels[PPG_NUM_CHANNELS] = {
+  PPG_ADC_CHANNEL,
+  #if PPG_NUM_CHANNELS >= 2
+  PPG_ADC_CHANNEL_2,
+  #endif
+  #if PPG_NUM_CHANNELS >= 3
+  PPG_ADC_CHANNEL_3,
+  #endif
+  #if PPG_NUM_CHANNELS >= 4
+  PPG_ADC_CHANNEL_4,
+  #endif
+};
+
+// Map a conversion's ADC channel number back to our board channel index.
+static int dmaChannelIndex(uint16_t adcChannel) {
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    if (ppgAdcChannels[c] == adcChannel) {
+      return c;
+    }
+  }
+  return -1;
+}
+
+static void samplerDmaTaskLoop(void* arg) {
+  static uint8_t readBuf[ADC_DMA_READ_BYTES];
+  // Channels decimate independently: conversions interleave, but each
+  // channel's stream lands on its own grid index at the same rate
+  uint32_t gridIndex[PPG_NUM_CHANNELS] = {0};
+  #ifndef ENABLE_OVERSAMPLING
+  uint32_t accum[PPG_NUM_CHANNELS] = {0};
+  int accumCount[PPG_NUM_CHANNELS] = {0};
+  #endif
+
+  for (;;) {
+    uint32_t bytesRead = 0;
+    esp_err_t err = adc_digi_read_bytes(readBuf, sizeof(readBuf),
+                                        &bytesRead, ADC_MAX_DELAY);
+    if (err != ESP_OK) {
+      continue;
+    }
+
+    int conversions = bytesRead / sizeof(adc_digi_output_data_t);
+    adc_digi_output_data_t* data = (adc_digi_output_data_t*)readBuf;
+
+    for (int i = 0; i < conversions; i++) {
+      #if CONFIG_IDF_TARGET_ESP32
+      uint16_t raw = data[i].type1.data;
+      int c = dmaChannelIndex(data[i].type1.channel);
+      #else
+      uint16_t raw = data[i].type2.data;
+      int c = dmaChannelIndex(data[i].type2.channel);
+      #endif
+      if (c < 0) {
+        continue;  // conversion from a channel we didn't configure
+      }
+      tickCount++;
+
+      #ifdef ENABLE_OVERSAMPLING
+      // Proper anti-aliasing FIR instead of the boxcar average
+      if (feedRawSample(c, raw, gridIndex[c])) {
+        gridIndex[c]++;
+      }
+      #else
+      accum[c] += raw;
+      if (++accumCount[c] >= ADC_DMA_DECIMATION) {
+        pushSample((uint16_t)(accum[c] / ADC_DMA_DECIMATION), (uint8_t)c,
+                   gridIndex[c]);
+        gridIndex[c]++;
+        accum[c] = 0;
+        accumCount[c] = 0;
+      }
+      #endif
+    }
+  }
+}
+
+void setupSampler() {
+  uint32_t chanMask = 0;
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    chanMask |= BIT(ppgAdcChannels[c]);
+  }
+
+  adc_digi_init_config_t initConfig = {
+    .max_store_buf_size = ADC_DMA_BUF_BYTES,
+    .conv_num_each_intr = ADC_DMA_READ_BYTES,
+    .adc1_chan_mask = chanMask,
+    .adc2_chan_mask = 0,
+  };
+  ESP_ERROR_CHECK(adc_digi_initialize(&initConfig));
+
+  // One pattern slot per channel; the controller cycles through them
+  adc_digi_pattern_config_t patterns[PPG_NUM_CHANNELS];
+  for (int c = 0; c < PPG_NUM_CHANNELS; c++) {
+    patterns[c].atten = ADC_ATTEN_DB_11;
+    patterns[c].channel = ppgAdcChannels[c];
+    patterns[c].unit = 0;  // ADC1
+    patterns[c].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+  }
+
+  adc_digi_configuration_t digiConfig = {
+    // The original ESP32 requires the conversion limit; later targets don't
+    #if CONFIG_IDF_TARGET_ESP32
+    .conv_limit_en = true,
+    #else
+    .conv_limit_en = false,
+    #endif
+    .conv_limit_num = 250,
+    .pattern_num = PPG_NUM_CHANNELS,
+    .adc_pattern = patterns,
+    // sample_freq_hz is the aggregate conversion rate; scale it so each
+    // channel still sees ADC_DMA_SAMPLE_RATE_HZ
+    .sample_freq_hz = ADC_DMA_SAMPLE_RATE_HZ * PPG_NUM_CHANNELS,
+    .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+    #if CONFIG_IDF_TARGET_ESP32
+    .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    #else
+    .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    #endif
+  };
+  ESP_ERROR_CHECK(adc_digi_controller_configure(&digiConfig));
+
+  xTaskCreatePinnedToCore(samplerDmaTaskLoop, "ppg_sampler",
+                          SAMPLER_TASK_STACK, NULL, SAMPLER_TASK_PRIORITY,
+                          &samplerTask, SAMPLING_CORE);
+
+  gridBaseMs = millis();
+  ESP_ERROR_CHECK(adc_digi_start());
+
+  Serial.print("Sampler started: ADC DMA at ");
+  Serial.print(ADC_DMA_SAMPLE_RATE_HZ);
+  Serial.print("Hz, averaged to ");
+  Serial.print(SAMPLE_RATE_HZ);
+  Serial.println("Hz");
+}
+
+#endif // ENABLE_ADC_DMA
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool samplerRead(TimedSample* out) {
+  uint32_t tail = ringTail;
+  if (tail == ringHead) {
+    return false;
+  }
+  *out = ring[tail];
+  ringTail = (tail + 1) & SAMPLER_RING_MASK;
+  return true;
+}
+
+unsigned long samplerGridBaseMs() {
+  return gridBaseMs;
+}
+
+uint32_t samplerTickCount() {
+  return tickCount;
+}
+
+uint32_t samplerOverrunCount() {
+  return overrunCount;
+}
+
+uint32_t samplerCaptureRateHz() {
+  return captureRateHz;
+}
+
+bool samplerSetRateHz(uint32_t hz) {
+  #if defined(ENABLE_ADC_DMA) || defined(ENABLE_OVERSAMPLING)
+  // The DMA controller rate and the FIR decimation factor are fixed at
+  // compile time; re-clocking them live would invalidate the filter design.
+  (void)hz;
+  return false;
+  #else
+
+  // Stop the clock, re-base the grid, then restart at the new period. The
+  // sampling task resets its grid index on the next wakeup, so timestamps
+  // stay consistent: new base plus ticks at the new rate.
+  #ifdef ENABLE_LIGHT_SLEEP
+  esp_timer_stop(espSampleTimer);
+  #else
+  timerAlarmDisable(sampleTimer);
+  #endif
+
+  captureRateHz = hz;
+  tickCount = 0;  // also re-bases the jitter reference (firstTickMicros)
+  gridBaseMs = millis();
+  gridResetPending = true;
+
+  #ifdef ENABLE_LIGHT_SLEEP
+  ESP_ERROR_CHECK(esp_timer_start_periodic(espSampleTimer, 1000000ULL / hz));
+  #else
+  timerAlarmWrite(sampleTimer, 1000000UL / hz, true);
+  timerAlarmEnable(sampleTimer);
+  #endif
+
+  return true;
+  #endif // ENABLE_ADC_DMA || ENABLE_OVERSAMPLING
+}
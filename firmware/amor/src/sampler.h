@@ -0,0 +1,60 @@
+/*
+ * Amor ESP32 Firmware - Hardware-timed PPG sampling engine
+ *
+ * Replaces the polled millis() grid in loop() with an ESP32 hardware timer.
+ * The timer fires every SAMPLE_INTERVAL_MS regardless of what loop() is doing
+ * (WiFi reconnects, stats printing), so sample timing no longer depends on
+ * loop latency.
+ *
+ * The IDF ADC driver is not callable from ISR context, so the timer ISR
+ * wakes a top-priority FreeRTOS task via direct task notification; the task
+ * performs the analogRead() within tens of microseconds of the tick and
+ * deposits the sample into a lock-free single-producer/single-consumer ring.
+ * loop() drains the ring with samplerRead().
+ *
+ * With ENABLE_ADC_DMA the ADC digital controller streams conversions into
+ * DMA buffers instead (zero CPU per conversion); the sampling task averages
+ * them down to the 50Hz grid. Same ring, same samplerRead() interface.
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+
+// One timed sample. gridIndex counts ticks since samplerStart(), so the
+// sample's scheduled time is samplerGridBaseMs() + gridIndex * SAMPLE_INTERVAL_MS.
+// With PPG_NUM_CHANNELS > 1 every grid slot yields one sample per channel,
+// read back-to-back within the tick (microseconds apart at most).
+struct TimedSample {
+  uint16_t value;       // Raw 12-bit ADC reading (0-4095)
+  uint8_t channel;      // Sensor channel on this board (0..PPG_NUM_CHANNELS-1)
+  uint32_t gridIndex;   // Tick number on the hardware 50Hz grid
+};
+
+// Configure the hardware timer and start the sampling task.
+// Must be called after setupADC().
+void setupSampler();
+
+// Pop the oldest sample from the ring. Returns false if the ring is empty.
+bool samplerRead(TimedSample* out);
+
+// millis() at the moment the hardware grid started (tick 0).
+unsigned long samplerGridBaseMs();
+
+// Total ticks fired by the hardware timer since start.
+uint32_t samplerTickCount();
+
+// Ticks whose sample was dropped because the ring was full (loop too slow).
+uint32_t samplerOverrunCount();
+
+// Rate the capture hardware runs at (SAMPLE_RATE_HZ, or the oversample/DMA
+// rate when those modes are enabled). Ticks count at this rate.
+uint32_t samplerCaptureRateHz();
+
+// Re-clock the capture timer at runtime (ENABLE_RUNTIME_CONFIG). Resets
+// the grid base so timestamps stay consistent. Returns false in the
+// fixed-rate DMA/oversampled capture modes.
+bool samplerSetRateHz(uint32_t hz);
+
+#endif // SAMPLER_H
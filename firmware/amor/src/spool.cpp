@@ -0,0 +1,222 @@
+#include <Arduino.h>
+#include "spool.h"
+
+#ifdef ENABLE_FLASH_SPOOL
+
+#include <spool_codec.h>
+#include "esp_partition.h"
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+// One flash erase sector per block; PSRAM uses the same size so the codec
+// and bookkeeping are identical across backings.
+#define SPOOL_BLOCK_SIZE 4096
+
+#ifndef SPOOL_PARTITION_LABEL
+#define SPOOL_PARTITION_LABEL "spool"
+#endif
+
+// PSRAM budget when available (~1.5 hours of delta-encoded bundles).
+#ifndef SPOOL_PSRAM_BYTES
+#define SPOOL_PSRAM_BYTES (512 * 1024)
+#endif
+
+// ============================================================================
+// State
+// ============================================================================
+
+// Backing store: exactly one of these is set after setupSpool()
+static uint8_t* psramBase = NULL;
+static const esp_partition_t* partition = NULL;
+static int blockCapacity = 0;      // Total blocks in the backing store
+
+// Circular block log
+static int blockHead = 0;          // Next block slot to commit
+static int blockTail = 0;          // Oldest committed block
+static int blockCount = 0;
+static int committedRecords = 0;   // Records across all committed blocks
+
+// Open write block and current read block
+static uint8_t writeBuf[SPOOL_BLOCK_SIZE];
+static SpoolBlockWriter writer;
+static uint8_t readBuf[SPOOL_BLOCK_SIZE];
+static SpoolBlockReader reader;
+static bool readerActive = false;
+
+static uint32_t droppedCount = 0;
+
+// ============================================================================
+// Block I/O (backing-store specific)
+// ============================================================================
+
+static void blockWrite(int index, const uint8_t* buf) {
+  if (psramBase != NULL) {
+    memcpy(psramBase + (size_t)index * SPOOL_BLOCK_SIZE, buf,
+           SPOOL_BLOCK_SIZE);
+  } else {
+    size_t offset = (size_t)index * SPOOL_BLOCK_SIZE;
+    esp_partition_erase_range(partition, offset, SPOOL_BLOCK_SIZE);
+    esp_partition_write(partition, offset, buf, SPOOL_BLOCK_SIZE);
+  }
+}
+
+static void blockRead(int index, uint8_t* buf) {
+  if (psramBase != NULL) {
+    memcpy(buf, psramBase + (size_t)index * SPOOL_BLOCK_SIZE,
+           SPOOL_BLOCK_SIZE);
+  } else {
+    esp_partition_read(partition, (size_t)index * SPOOL_BLOCK_SIZE, buf,
+                       SPOOL_BLOCK_SIZE);
+  }
+}
+
+// Record count of a committed block without pulling the whole block in.
+static int blockPeekCount(int index) {
+  uint8_t header[SPOOL_CODEC_HEADER_SIZE];
+  if (psramBase != NULL) {
+    memcpy(header, psramBase + (size_t)index * SPOOL_BLOCK_SIZE,
+           sizeof(header));
+  } else {
+    esp_partition_read(partition, (size_t)index * SPOOL_BLOCK_SIZE, header,
+                       sizeof(header));
+  }
+  int count = spoolCodecPeekCount(header, sizeof(header));
+  return (count > 0) ? count : 0;
+}
+
+// ============================================================================
+// Tier management
+// ============================================================================
+
+// Seal the open write block into the circular log, evicting the oldest
+// block if the spool is full.
+static void commitWriteBlock() {
+  size_t len = spoolCodecFinish(&writer);
+  if (len == 0) {
+    return;
+  }
+  // Unused tail of the block stays whatever it was; the codec header's
+  // record count bounds the reader.
+
+  if (blockCount == blockCapacity) {
+    int lost = blockPeekCount(blockTail);
+    droppedCount += lost;
+    committedRecords -= lost;
+    blockTail = (blockTail + 1) % blockCapacity;
+    blockCount--;
+  }
+
+  blockWrite(blockHead, writeBuf);
+  committedRecords += spoolCodecWriterCount(&writer);
+  blockHead = (blockHead + 1) % blockCapacity;
+  blockCount++;
+
+  spoolCodecWriterInit(&writer, writeBuf, sizeof(writeBuf));
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void setupSpool() {
+  if (psramFound()) {
+    psramBase = (uint8_t*)ps_malloc(SPOOL_PSRAM_BYTES);
+  }
+  if (psramBase != NULL) {
+    blockCapacity = SPOOL_PSRAM_BYTES / SPOOL_BLOCK_SIZE;
+    Serial.print("Spool: PSRAM, ");
+  } else {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                         ESP_PARTITION_SUBTYPE_ANY,
+                                         SPOOL_PARTITION_LABEL);
+    if (partition == NULL) {
+      Serial.println("Spool: DISABLED (no PSRAM, no '" SPOOL_PARTITION_LABEL
+                     "' partition - see partitions_spool.csv)");
+      return;
+    }
+    blockCapacity = partition->size / SPOOL_BLOCK_SIZE;
+    Serial.print("Spool: flash partition, ");
+  }
+
+  spoolCodecWriterInit(&writer, writeBuf, sizeof(writeBuf));
+
+  Serial.print(blockCapacity);
+  Serial.print(" blocks (");
+  Serial.print((blockCapacity * SPOOL_BLOCK_SIZE) / 1024);
+  Serial.println("KB)");
+}
+
+bool spoolPush(const BundleRecord* record) {
+  if (blockCapacity == 0) {
+    return false;  // no backing store
+  }
+
+  if (spoolCodecWrite(&writer, record->samples, BUNDLE_SIZE, record->channel,
+                      record->timestampMs)) {
+    return true;
+  }
+
+  // Block full: seal it and retry in a fresh one
+  commitWriteBlock();
+  return spoolCodecWrite(&writer, record->samples, BUNDLE_SIZE,
+                         record->channel, record->timestampMs);
+}
+
+bool spoolPop(BundleRecord* out) {
+  if (blockCapacity == 0) {
+    return false;
+  }
+
+  if (!readerActive) {
+    if (blockCount > 0) {
+      // Oldest committed block first
+      blockRead(blockTail, readBuf);
+      int records = blockPeekCount(blockTail);
+      blockTail = (blockTail + 1) % blockCapacity;
+      blockCount--;
+      committedRecords -= records;
+      if (!spoolCodecReaderInit(&reader, readBuf, sizeof(readBuf))) {
+        return spoolPop(out);  // corrupt block; skip to the next
+      }
+      readerActive = true;
+    } else if (spoolCodecWriterCount(&writer) > 0) {
+      // Nothing committed: drain the open write block in place
+      size_t len = spoolCodecFinish(&writer);
+      memcpy(readBuf, writeBuf, len);
+      spoolCodecWriterInit(&writer, writeBuf, sizeof(writeBuf));
+      if (!spoolCodecReaderInit(&reader, readBuf, len)) {
+        return false;
+      }
+      readerActive = true;
+    } else {
+      return false;
+    }
+  }
+
+  int count = 0;
+  if (!spoolCodecRead(&reader, out->samples, BUNDLE_SIZE, &count,
+                      &out->channel, &out->timestampMs)) {
+    readerActive = false;
+    return spoolPop(out);  // block exhausted; move to the next
+  }
+
+  // Short records can only come from a BUNDLE_SIZE change mid-session;
+  // pad with the last value rather than ship uninitialized samples
+  for (int i = count; i < BUNDLE_SIZE; i++) {
+    out->samples[i] = out->samples[count - 1];
+  }
+  return true;
+}
+
+int spoolCount() {
+  int inReader = readerActive ? reader.remaining : 0;
+  return committedRecords + spoolCodecWriterCount(&writer) + inReader;
+}
+
+uint32_t spoolDroppedCount() {
+  return droppedCount;
+}
+
+#endif // ENABLE_FLASH_SPOOL
@@ -0,0 +1,59 @@
+/*
+ * Amor ESP32 Firmware - Flash/PSRAM spool tier for long outages
+ *
+ * The RAM backlog (backlog.cpp) covers short WiFi drops, but the venue AP
+ * takes 2-3 minutes to reboot and the WROOM units have no RAM to spare for
+ * minutes of samples. With ENABLE_FLASH_SPOOL, bundles the RAM ring would
+ * have dropped are delta-encoded (lib/ppgspool) into 4KB blocks and spooled
+ * to a second tier instead:
+ *
+ *   - PSRAM when the board has it (SPOOL_PSRAM_BYTES, default 512KB —
+ *     about 1.5 hours of samples), or
+ *   - a dedicated flash partition (SPOOL_PARTITION_LABEL, see
+ *     partitions_spool.csv), written in erase-aligned blocks.
+ *
+ * The spool always holds records older than everything in the RAM ring, so
+ * the drain order in backlog.cpp (spool first, then RAM) keeps replayed
+ * bundles in timestamp order. Contents are session-scoped: the spool does
+ * not survive a reboot, it exists so multi-minute outages replay completely.
+ *
+ * Only the network task touches the spool, same as the backlog.
+ */
+
+#ifndef SPOOL_H
+#define SPOOL_H
+
+#include <stdint.h>
+#include "backlog.h"
+#include "../include/config.h"
+
+#ifdef ENABLE_FLASH_SPOOL
+
+// Locate the backing store (PSRAM, else the flash partition). Call once
+// from setup(); without a backing store the spool stays disabled and
+// pushes fail over to the drop counter.
+void setupSpool();
+
+// Append a record evicted from the RAM ring. Returns false if the spool
+// is unavailable (record is lost; caller counts the drop).
+bool spoolPush(const BundleRecord* record);
+
+// Pop the oldest spooled record. Returns false when the spool is empty.
+bool spoolPop(BundleRecord* out);
+
+// Records currently spooled (committed blocks plus the open write block).
+int spoolCount();
+
+// Records evicted because the outage outlived the spool too.
+uint32_t spoolDroppedCount();
+
+#else
+
+// Without the tier the backlog keeps its original overwrite behavior.
+inline void setupSpool() {}
+inline int spoolCount() { return 0; }
+inline uint32_t spoolDroppedCount() { return 0; }
+
+#endif // ENABLE_FLASH_SPOOL
+
+#endif // SPOOL_H
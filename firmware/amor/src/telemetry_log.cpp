@@ -0,0 +1,166 @@
+#include <Arduino.h>
+#include <string.h>
+#include "telemetry_log.h"
+
+// Drain task: below even the sender task, pinned with the other network-
+// side work. All the time it spends blocked on the UART FIFO is time no
+// one else wanted.
+#ifndef NETWORK_CORE
+#define NETWORK_CORE 0
+#endif
+#define TLOG_DRAIN_PRIORITY 1
+#define TLOG_DRAIN_STACK 4096
+
+// One logged event, sealed at the call site, formatted by the drain task.
+struct TlogRecord {
+  uint32_t timestampMs;
+  uint16_t event;
+  uint8_t level;
+  uint8_t argc;
+  int32_t args[3];
+};
+
+// printf lines per event, indexed by TlogEvent. Unused %ld specifiers must
+// not appear — the drain task passes exactly the recorded args.
+static const char* const eventFormats[TLOG_EVT_COUNT] = {
+  "WiFi down, auto-reconnect in progress (status=%ld)",  // WIFI_DOWN
+  "TxQ full, bundle dropped (%ld total)",                // TXQ_DROP
+  "Backlog full, oldest bundle overwritten (%ld total)", // BACKLOG_DROP
+  "NACKed seq %ld aged out of the retransmit history",   // NACK_MISS
+  "Oversized admin packet ignored (%ld bytes)",          // OVERSIZE_PACKET
+  "Quality gate: channel %ld -> %ld (0=active 1=flat 2=noisy)", // QG_STATE
+  "TX power -> %ld quarter-dBm (loss %ld/1000, RSSI %lddBm)",   // TX_POWER
+};
+
+static const char levelChars[] = {'-', 'E', 'W', 'I', 'D'};
+
+// Multi-producer (sampling, network, sender, WiFi-event tasks), single-
+// consumer ring. head/tail are monotonic; the spinlock covers the ~dozen
+// instructions of the append, which is the entire hot-path cost of a
+// compiled-in log statement.
+static TlogRecord ring[TLOG_RING_RECORDS];
+static volatile uint32_t ringHead = 0;
+static volatile uint32_t ringTail = 0;
+static uint32_t droppedCount = 0;
+static portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t drainTaskHandle = NULL;
+
+// The periodic stats line travels outside the ring: it is built whole by
+// printStats() and only the UART write is deferred. A fresh line replaces
+// an undrained one (it is a snapshot, the newest wins).
+static char pendingLine[256];
+static volatile bool linePending = false;
+
+static void appendRecord(uint8_t level, uint16_t event, uint8_t argc,
+                         int32_t a0, int32_t a1, int32_t a2) {
+  uint32_t now = millis();
+
+  portENTER_CRITICAL(&ringMux);
+  if (ringHead - ringTail >= TLOG_RING_RECORDS) {
+    droppedCount++;  // drain task starved; counted, shown in the stats line
+    portEXIT_CRITICAL(&ringMux);
+    return;
+  }
+  TlogRecord& slot = ring[ringHead % TLOG_RING_RECORDS];
+  slot.timestampMs = now;
+  slot.event = event;
+  slot.level = level;
+  slot.argc = argc;
+  slot.args[0] = a0;
+  slot.args[1] = a1;
+  slot.args[2] = a2;
+  ringHead = ringHead + 1;
+  portEXIT_CRITICAL(&ringMux);
+
+  if (drainTaskHandle != NULL) {
+    xTaskNotifyGive(drainTaskHandle);
+  }
+}
+
+void tlogAppend(uint8_t level, uint16_t event) {
+  appendRecord(level, event, 0, 0, 0, 0);
+}
+
+void tlogAppend(uint8_t level, uint16_t event, int32_t a0) {
+  appendRecord(level, event, 1, a0, 0, 0);
+}
+
+void tlogAppend(uint8_t level, uint16_t event, int32_t a0, int32_t a1) {
+  appendRecord(level, event, 2, a0, a1, 0);
+}
+
+void tlogAppend(uint8_t level, uint16_t event, int32_t a0, int32_t a1,
+                int32_t a2) {
+  appendRecord(level, event, 3, a0, a1, a2);
+}
+
+void tlogPrintLine(const char* line) {
+  portENTER_CRITICAL(&ringMux);
+  strlcpy(pendingLine, line, sizeof(pendingLine));
+  linePending = true;
+  portEXIT_CRITICAL(&ringMux);
+
+  if (drainTaskHandle != NULL) {
+    xTaskNotifyGive(drainTaskHandle);
+  }
+}
+
+uint32_t tlogDroppedCount() {
+  return droppedCount;
+}
+
+// Format one record the way the old inline prints looked:
+//   [123.456s] W WiFi down, auto-reconnect in progress (status=5)
+static void drainPrint(const TlogRecord& record) {
+  char line[160];
+  int written = snprintf(line, sizeof(line), "[%lu.%03lus] %c ",
+                         record.timestampMs / 1000,
+                         record.timestampMs % 1000,
+                         levelChars[record.level]);
+  if (record.event < TLOG_EVT_COUNT) {
+    snprintf(line + written, sizeof(line) - written,
+             eventFormats[record.event], (long)record.args[0],
+             (long)record.args[1], (long)record.args[2]);
+  } else {
+    snprintf(line + written, sizeof(line) - written,
+             "unknown event %u (%ld, %ld, %ld)", record.event,
+             (long)record.args[0], (long)record.args[1],
+             (long)record.args[2]);
+  }
+  Serial.println(line);
+}
+
+static void drainTaskLoop(void* arg) {
+  char line[sizeof(pendingLine)];
+
+  for (;;) {
+    ulTaskNotifyTake(pdFALSE, pdMS_TO_TICKS(1000));
+
+    // Slots between tail and head are sealed and stable (producers stop at
+    // tail), so records copy out without the lock
+    while (ringTail != ringHead) {
+      TlogRecord record = ring[ringTail % TLOG_RING_RECORDS];
+      ringTail = ringTail + 1;
+      drainPrint(record);
+    }
+
+    if (linePending) {
+      portENTER_CRITICAL(&ringMux);
+      strlcpy(line, pendingLine, sizeof(line));
+      linePending = false;
+      portEXIT_CRITICAL(&ringMux);
+      Serial.println(line);
+    }
+  }
+}
+
+void setupTelemetryLog() {
+  xTaskCreatePinnedToCore(drainTaskLoop, "tlog_drain", TLOG_DRAIN_STACK,
+                          NULL, TLOG_DRAIN_PRIORITY, &drainTaskHandle,
+                          NETWORK_CORE);
+  Serial.print("Telemetry log: level ");
+  Serial.print(TLOG_LEVEL);
+  Serial.print(", ");
+  Serial.print(TLOG_RING_RECORDS);
+  Serial.println("-record ring");
+}
@@ -0,0 +1,101 @@
+/*
+ * Amor ESP32 Firmware - Non-blocking telemetry log
+ *
+ * A 200-byte stats line takes ~20ms to leave the UART at 115200 baud, and
+ * Serial blocks the caller once its TX FIFO fills. That was tolerable when
+ * loop() did everything; with sealing, admin handling and sends sharing
+ * the network task, a UART stall is transmit latency. Logging call sites
+ * now append a fixed-size binary record to a small ring — a dozen
+ * instructions under a cross-core spinlock, never the UART — and a
+ * low-priority drain task formats the records and performs the serial
+ * writes, where blocking costs nothing.
+ *
+ * Statements are leveled at compile time: anything above TLOG_LEVEL
+ * (override in config.h; default INFO) expands to nothing at all, so a
+ * disabled TLOG_DEBUG on a hot path costs zero instructions.
+ *
+ * Task context only (the append takes the spinlock and notifies the drain
+ * task); ISRs should keep counting into volatile counters as the sampler
+ * does and let a task log the excursion.
+ */
+
+#ifndef TELEMETRY_LOG_H
+#define TELEMETRY_LOG_H
+
+#include <stdint.h>
+#include "../include/config.h"
+
+// Compile-time log levels. A statement below or at TLOG_LEVEL is compiled
+// in; everything above it disappears entirely.
+#define TLOG_LEVEL_NONE 0
+#define TLOG_LEVEL_ERROR 1
+#define TLOG_LEVEL_WARN 2
+#define TLOG_LEVEL_INFO 3
+#define TLOG_LEVEL_DEBUG 4
+
+#ifndef TLOG_LEVEL
+#define TLOG_LEVEL TLOG_LEVEL_INFO
+#endif
+
+// Records awaiting the drain task. Each is 20 bytes; the default ring is
+// well over a minute of headroom at any sane event rate.
+#ifndef TLOG_RING_RECORDS
+#define TLOG_RING_RECORDS 64
+#endif
+
+// Known events; the format strings live in telemetry_log.cpp. Add the
+// event here and its line there.
+enum TlogEvent : uint16_t {
+  TLOG_EVT_WIFI_DOWN,        // a0 = WiFi.status()
+  TLOG_EVT_TXQ_DROP,         // a0 = total bundles dropped at the tx queue
+  TLOG_EVT_BACKLOG_DROP,     // a0 = total bundles the backlog overwrote
+  TLOG_EVT_NACK_MISS,        // a0 = NACKed seq that aged out of history
+  TLOG_EVT_OVERSIZE_PACKET,  // a0 = admin datagram size in bytes
+  TLOG_EVT_QG_STATE,         // a0 = channel, a1 = QualityState
+  TLOG_EVT_TX_POWER,         // a0 = quarter-dBm, a1 = loss permille, a2 = RSSI
+  TLOG_EVT_COUNT
+};
+
+// Start the drain task. Call before the tasks that log.
+void setupTelemetryLog();
+
+// Append one record (timestamped here). Prefer the TLOG_* macros so the
+// level gating stays compile-time.
+void tlogAppend(uint8_t level, uint16_t event);
+void tlogAppend(uint8_t level, uint16_t event, int32_t a0);
+void tlogAppend(uint8_t level, uint16_t event, int32_t a0, int32_t a1);
+void tlogAppend(uint8_t level, uint16_t event, int32_t a0, int32_t a1,
+                int32_t a2);
+
+// Hand a prebuilt line (the periodic stats line) to the drain task for the
+// UART write. The line is copied; an undrained previous line is replaced.
+void tlogPrintLine(const char* line);
+
+// Records dropped because the ring was full (drain task starved).
+uint32_t tlogDroppedCount();
+
+#if TLOG_LEVEL >= TLOG_LEVEL_ERROR
+#define TLOG_ERROR(...) tlogAppend(TLOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define TLOG_ERROR(...) ((void)0)
+#endif
+
+#if TLOG_LEVEL >= TLOG_LEVEL_WARN
+#define TLOG_WARN(...) tlogAppend(TLOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define TLOG_WARN(...) ((void)0)
+#endif
+
+#if TLOG_LEVEL >= TLOG_LEVEL_INFO
+#define TLOG_INFO(...) tlogAppend(TLOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define TLOG_INFO(...) ((void)0)
+#endif
+
+#if TLOG_LEVEL >= TLOG_LEVEL_DEBUG
+#define TLOG_DEBUG(...) tlogAppend(TLOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define TLOG_DEBUG(...) ((void)0)
+#endif
+
+#endif // TELEMETRY_LOG_H
@@ -0,0 +1,54 @@
+#include <Arduino.h>
+#include "timing_stats.h"
+
+// Written from the timer ISR, read/cleared from the network task. Torn
+// reads across a snapshot boundary cost at most one miscounted tick, which
+// is acceptable for 5-second dashboard aggregates; taking a lock in the
+// ISR is not.
+static volatile uint32_t samples = 0;
+static volatile int32_t minUs = 0;
+static volatile int32_t maxUs = 0;
+static volatile int64_t sumUs = 0;
+static volatile uint32_t histogram[TIMING_STATS_BUCKETS] = {0};
+
+// Bucket upper bounds in microseconds (last bucket is open-ended)
+static const int32_t kBucketLimitUs[TIMING_STATS_BUCKETS - 1] = {
+  50, 100, 250, 500, 1000, 2500, 5000
+};
+
+void IRAM_ATTR timingStatsRecord(int32_t deviationUs) {
+  if (samples == 0 || deviationUs < minUs) minUs = deviationUs;
+  if (samples == 0 || deviationUs > maxUs) maxUs = deviationUs;
+  sumUs += deviationUs;
+  samples++;
+
+  int32_t mag = (deviationUs < 0) ? -deviationUs : deviationUs;
+  int bucket = TIMING_STATS_BUCKETS - 1;
+  for (int i = 0; i < TIMING_STATS_BUCKETS - 1; i++) {
+    if (mag < kBucketLimitUs[i]) {
+      bucket = i;
+      break;
+    }
+  }
+  histogram[bucket]++;
+}
+
+void timingStatsSnapshot(TimingStatsSnapshot* out, bool reset) {
+  out->samples = samples;
+  out->minUs = minUs;
+  out->maxUs = maxUs;
+  out->avgUs = (samples > 0) ? (int32_t)(sumUs / (int32_t)samples) : 0;
+  for (int i = 0; i < TIMING_STATS_BUCKETS; i++) {
+    out->histogram[i] = histogram[i];
+  }
+
+  if (reset) {
+    samples = 0;
+    minUs = 0;
+    maxUs = 0;
+    sumUs = 0;
+    for (int i = 0; i < TIMING_STATS_BUCKETS; i++) {
+      histogram[i] = 0;
+    }
+  }
+}
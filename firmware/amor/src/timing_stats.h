@@ -0,0 +1,42 @@
+/*
+ * Amor ESP32 Firmware - Sampling-jitter instrumentation
+ *
+ * printStats() reports ADC value statistics but nothing about timing, and
+ * loop jitter silently corrupts IBI measurements (the PulseSensor reference
+ * ships PulseSensorTimingStatistics for exactly this reason). This module
+ * records each capture tick's deviation from its scheduled grid slot —
+ * measured in the timer ISR itself, so the numbers reflect the hardware
+ * grid, not drain latency — and aggregates min/avg/max plus a magnitude
+ * histogram. The network task publishes a snapshot periodically as
+ * /stats/N so per-unit jitter is visible in production dashboards instead
+ * of only over a USB cable.
+ *
+ * In ADC-DMA mode there is no per-sample CPU timestamp; only the tick and
+ * overrun counters are meaningful there.
+ */
+
+#ifndef TIMING_STATS_H
+#define TIMING_STATS_H
+
+#include <stdint.h>
+
+// Histogram buckets by absolute deviation: <50us, <100us, <250us, <500us,
+// <1ms, <2.5ms, <5ms, >=5ms.
+#define TIMING_STATS_BUCKETS 8
+
+struct TimingStatsSnapshot {
+  uint32_t samples;                       // Ticks recorded in this window
+  int32_t minUs;                          // Most negative deviation seen
+  int32_t maxUs;                          // Most positive deviation seen
+  int32_t avgUs;                          // Mean deviation
+  uint32_t histogram[TIMING_STATS_BUCKETS];
+};
+
+// Record one tick's deviation from its scheduled time, in microseconds.
+// Called from the sample timer ISR; keep it cheap (IRAM, integer only).
+void timingStatsRecord(int32_t deviationUs);
+
+// Copy out the current window and optionally reset it for the next one.
+void timingStatsSnapshot(TimingStatsSnapshot* out, bool reset);
+
+#endif // TIMING_STATS_H
@@ -0,0 +1,56 @@
+#include <Arduino.h>
+#include "lwip/sockets.h"
+#include "udp_out.h"
+
+static int sock = -1;
+static uint32_t errorCount = 0;
+
+bool udpOutSetup(IPAddress serverIP, uint16_t port) {
+  if (sock >= 0) {
+    close(sock);
+    sock = -1;
+  }
+
+  sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+  if (sock < 0) {
+    Serial.println("ERROR: UDP out socket creation failed");
+    return false;
+  }
+
+  struct sockaddr_in dest;
+  memset(&dest, 0, sizeof(dest));
+  dest.sin_family = AF_INET;
+  dest.sin_port = htons(port);
+  dest.sin_addr.s_addr = (uint32_t)serverIP;
+
+  // Connecting fixes the destination once; send() then skips the per-packet
+  // route/destination setup that sendto() repeats every time
+  if (connect(sock, (struct sockaddr*)&dest, sizeof(dest)) < 0) {
+    Serial.println("ERROR: UDP out socket connect failed");
+    close(sock);
+    sock = -1;
+    return false;
+  }
+
+  // Never let the sender block on a full driver queue; drop instead
+  int flags = fcntl(sock, F_GETFL, 0);
+  fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+  return true;
+}
+
+bool udpOutSend(const uint8_t* data, size_t len) {
+  if (sock < 0) {
+    return false;
+  }
+
+  if (send(sock, data, len, 0) < 0) {
+    errorCount++;
+    return false;
+  }
+  return true;
+}
+
+uint32_t udpOutErrorCount() {
+  return errorCount;
+}
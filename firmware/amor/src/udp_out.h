@@ -0,0 +1,34 @@
+/*
+ * Amor ESP32 Firmware - Direct UDP transmit path
+ *
+ * WiFiUDP::beginPacket/write/endPacket copies every bundle through the
+ * Arduino wrapper's internal buffer before it reaches lwIP, and rebuilds
+ * the destination on every packet. The destination is fixed at boot
+ * (SERVER_IP:SERVER_PORT), so we instead keep one connected lwIP datagram
+ * socket and hand each preformatted datagram straight to send().
+ *
+ * The raw udp_sendto/pbuf API would shave one more copy, but IDF builds
+ * ship with lwIP core locking disabled, so every raw call would have to
+ * bounce through tcpip_callback — more overhead than the copy it saves.
+ * The connected socket is the fastest path that is safe from any task.
+ */
+
+#ifndef UDP_OUT_H
+#define UDP_OUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <IPAddress.h>
+
+// Open (or reopen) the connected socket to the server. Returns false on
+// socket errors. Safe to call again after a WiFi reconnect.
+bool udpOutSetup(IPAddress serverIP, uint16_t port);
+
+// Send one preformatted datagram. Returns false if the socket is not up
+// or the stack refused the packet (counted; see udpOutErrorCount).
+bool udpOutSend(const uint8_t* data, size_t len);
+
+// Datagrams the stack refused (ENOMEM under radio backpressure, etc.).
+uint32_t udpOutErrorCount();
+
+#endif // UDP_OUT_H
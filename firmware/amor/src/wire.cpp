@@ -0,0 +1,97 @@
+#include "wire.h"
+
+static void putUint32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)(v & 0xFF);
+}
+
+// Pack 12-bit samples MSB-first: two samples span three bytes.
+static void packSamples(uint8_t* p, const uint16_t* samples, uint16_t count) {
+  uint32_t bitPos = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t v = samples[i] & 0x0FFF;
+    if ((bitPos & 7) == 0) {
+      p[bitPos >> 3] = (uint8_t)(v >> 4);
+      p[(bitPos >> 3) + 1] = (uint8_t)((v & 0x0F) << 4);
+    } else {
+      p[bitPos >> 3] |= (uint8_t)(v >> 8);
+      p[(bitPos >> 3) + 1] = (uint8_t)(v & 0xFF);
+    }
+    bitPos += PPG_WIRE_BITS_PER_SAMPLE;
+  }
+}
+
+size_t ppgWirePack(uint8_t* out, const uint16_t* samples, uint16_t count,
+                   uint32_t timestampMs) {
+  out[0] = PPG_WIRE_VERSION;
+  out[1] = PPG_WIRE_BITS_PER_SAMPLE;
+  out[2] = (uint8_t)(count >> 8);
+  out[3] = (uint8_t)(count & 0xFF);
+  putUint32(out + 4, timestampMs);
+
+  packSamples(out + PPG_WIRE_HEADER_SIZE, samples, count);
+
+  return PPG_WIRE_BLOB_SIZE(count);
+}
+
+size_t ppgWirePackSeq(uint8_t* out, const uint16_t* samples, uint16_t count,
+                      uint32_t timestampMs, uint32_t seq) {
+  out[0] = PPG_WIRE_VERSION_SEQ;
+  out[1] = PPG_WIRE_BITS_PER_SAMPLE;
+  out[2] = (uint8_t)(count >> 8);
+  out[3] = (uint8_t)(count & 0xFF);
+  putUint32(out + 4, timestampMs);
+  putUint32(out + 8, seq);
+
+  packSamples(out + PPG_WIRE_HEADER_SIZE_SEQ, samples, count);
+
+  return PPG_WIRE_BLOB_SIZE_SEQ(count);
+}
+
+int ppgWireUnpack(const uint8_t* blob, size_t blobLen, uint16_t* samples,
+                  uint16_t maxSamples, uint32_t* timestampMs, uint32_t* seq) {
+  if (blobLen < PPG_WIRE_HEADER_SIZE) {
+    return -1;
+  }
+  if ((blob[0] != PPG_WIRE_VERSION && blob[0] != PPG_WIRE_VERSION_SEQ) ||
+      blob[1] != PPG_WIRE_BITS_PER_SAMPLE) {
+    return -1;
+  }
+  bool hasSeq = (blob[0] == PPG_WIRE_VERSION_SEQ);
+  size_t headerSize = hasSeq ? PPG_WIRE_HEADER_SIZE_SEQ : PPG_WIRE_HEADER_SIZE;
+  if (blobLen < headerSize) {
+    return -1;
+  }
+
+  uint16_t count = ((uint16_t)blob[2] << 8) | blob[3];
+  size_t need = hasSeq ? PPG_WIRE_BLOB_SIZE_SEQ(count)
+                       : PPG_WIRE_BLOB_SIZE(count);
+  if (count > maxSamples || blobLen < need) {
+    return -1;
+  }
+
+  *timestampMs = ((uint32_t)blob[4] << 24) | ((uint32_t)blob[5] << 16) |
+                 ((uint32_t)blob[6] << 8) | blob[7];
+  if (seq != NULL) {
+    *seq = hasSeq ? (((uint32_t)blob[8] << 24) | ((uint32_t)blob[9] << 16) |
+                     ((uint32_t)blob[10] << 8) | blob[11])
+                  : 0;
+  }
+
+  const uint8_t* p = blob + headerSize;
+  uint32_t bitPos = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if ((bitPos & 7) == 0) {
+      samples[i] = ((uint16_t)p[bitPos >> 3] << 4) |
+                   (p[(bitPos >> 3) + 1] >> 4);
+    } else {
+      samples[i] = (((uint16_t)p[bitPos >> 3] & 0x0F) << 8) |
+                   p[(bitPos >> 3) + 1];
+    }
+    bitPos += PPG_WIRE_BITS_PER_SAMPLE;
+  }
+
+  return count;
+}
@@ -0,0 +1,65 @@
+/*
+ * Amor ESP32 Firmware - Packed PPG wire format
+ *
+ * The classic bundle encodes every 12-bit ADC sample as a separate OSC
+ * int32 (4 bytes plus type-tag overhead per sample). The packed format
+ * instead ships one OSC blob per bundle: a small self-describing header
+ * followed by tightly packed samples, cutting UDP payload size (and radio
+ * airtime across four senders) by roughly 3x.
+ *
+ * Blob layout (all multi-byte fields big-endian, matching OSC):
+ *   uint8   version        (PPG_WIRE_VERSION or PPG_WIRE_VERSION_SEQ)
+ *   uint8   bitsPerSample  (12)
+ *   uint16  sampleCount
+ *   uint32  timestampMs    (millis of first sample in bundle)
+ *   uint32  seq            (version 2 only: transmit sequence number)
+ *   uint8[] samples        packed MSB-first, padded to a byte boundary
+ *
+ * Selected at compile time via ENABLE_PACKED_BUNDLES in config.h. The
+ * header is self-describing so the server can parse bundles without
+ * knowing the sender's BUNDLE_SIZE or sample width. Version 2
+ * (ENABLE_SEQ_RETRANSMIT) adds a per-unit monotonic sequence number so
+ * the receiver can tell loss from reordering and NACK the holes.
+ *
+ * This file is deliberately free of Arduino dependencies so the server
+ * side can compile the same encoder/decoder.
+ */
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PPG_WIRE_VERSION 1
+#define PPG_WIRE_VERSION_SEQ 2
+#define PPG_WIRE_BITS_PER_SAMPLE 12
+#define PPG_WIRE_HEADER_SIZE 8
+#define PPG_WIRE_HEADER_SIZE_SEQ 12
+
+// Bytes needed for a packed blob carrying `count` samples.
+#define PPG_WIRE_BLOB_SIZE(count) \
+  (PPG_WIRE_HEADER_SIZE + (((count) * PPG_WIRE_BITS_PER_SAMPLE + 7) / 8))
+#define PPG_WIRE_BLOB_SIZE_SEQ(count) \
+  (PPG_WIRE_HEADER_SIZE_SEQ + (((count) * PPG_WIRE_BITS_PER_SAMPLE + 7) / 8))
+
+// Pack `count` 12-bit samples plus the bundle timestamp into `out`.
+// `out` must hold at least PPG_WIRE_BLOB_SIZE(count) bytes.
+// Returns the number of bytes written.
+size_t ppgWirePack(uint8_t* out, const uint16_t* samples, uint16_t count,
+                   uint32_t timestampMs);
+
+// Version-2 variant: same layout with the transmit sequence number in the
+// header. `out` must hold at least PPG_WIRE_BLOB_SIZE_SEQ(count) bytes.
+size_t ppgWirePackSeq(uint8_t* out, const uint16_t* samples, uint16_t count,
+                      uint32_t timestampMs, uint32_t seq);
+
+// Decode a packed blob (either version) into `samples` (capacity
+// `maxSamples`). On success returns the sample count and stores the bundle
+// timestamp in `timestampMs`; `seq` (may be NULL) receives the sequence
+// number for version-2 blobs and 0 otherwise. Returns -1 if the blob is
+// malformed or too large.
+int ppgWireUnpack(const uint8_t* blob, size_t blobLen, uint16_t* samples,
+                  uint16_t maxSamples, uint32_t* timestampMs, uint32_t* seq);
+
+#endif // WIRE_H
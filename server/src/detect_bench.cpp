@@ -0,0 +1,343 @@
+/*
+ * Amor server - offline benchmark harness for the beat detector
+ *
+ * Replays PPG traces through the shared BeatDetector (and optionally the
+ * FIR decimator) on the host and reports cost and accuracy, so detector or
+ * filter changes come with before/after numbers instead of a live-hardware
+ * shrug. Two input paths:
+ *
+ *   --trace FILE    a recording in the amor/capture.py binary format
+ *                   ("PPGL" header, little-endian int32 records). No ground
+ *                   truth, so only cost and detection counts are reported.
+ *
+ *   --synth SECS    a synthetic pulse train with known beat times, enabling
+ *                   detected-vs-truth matching and IBI error distributions.
+ *                   --bpm, --hrv (IBI jitter, ms) and --noise (ADC counts,
+ *                   RMS) shape the signal.
+ *
+ * Cost is reported as ns/sample and samples/s on this host; multiply by
+ * the target clock ratio for a rough on-device estimate (the kernel is
+ * integer-only, so it scales close to linearly with clock rate).
+ *
+ * Usage:
+ *   amor-detect-bench --synth 300 --bpm 72 --noise 30 --hrv 40
+ *   amor-detect-bench --trace data/ppg_20250101_120000.bin
+ *   amor-detect-bench --synth 300 --decimate 10   # 500Hz capture path
+ *   amor-detect-bench --synth 300 --noise 30 --filter   # conditioning stage
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <beat_detector.h>
+#include <decimator.h>
+#include <ppg_filter.h>
+
+#define WIRE_RATE_HZ 50
+#define WIRE_INTERVAL_MS (1000 / WIRE_RATE_HZ)
+
+struct TruthBeat {
+  double timeMs;   // Ground-truth beat (pulse foot) time
+};
+
+// ============================================================================
+// Trace input (amor/capture.py PPGL format)
+// ============================================================================
+
+static uint32_t getLe32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static bool loadTrace(const char* path, std::vector<uint16_t>* samples) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+
+  uint8_t header[8];
+  if (fread(header, 1, sizeof(header), f) != sizeof(header) ||
+      memcmp(header, "PPGL", 4) != 0 || header[4] != 1) {
+    fprintf(stderr, "%s: not a PPGL v1 capture\n", path);
+    fclose(f);
+    return false;
+  }
+  printf("Trace: %s (PPG ID %d)\n", path, header[5]);
+
+  // Records: int32 timestamp_ms + 5x int32 samples, little-endian
+  uint8_t record[24];
+  while (fread(record, 1, sizeof(record), f) == sizeof(record)) {
+    for (int i = 0; i < 5; i++) {
+      samples->push_back((uint16_t)getLe32(record + 4 + i * 4));
+    }
+  }
+  fclose(f);
+  return !samples->empty();
+}
+
+// ============================================================================
+// Synthetic input with ground truth
+// ============================================================================
+
+// Gaussian systolic peak plus a smaller dicrotic bump per beat, on a 2048
+// baseline — close enough to our real sensor shapes for threshold dynamics.
+static void synthesize(double seconds, double bpm, double hrvMs,
+                       double noiseRms, int rateHz,
+                       std::vector<uint16_t>* samples,
+                       std::vector<TruthBeat>* truth) {
+  std::mt19937 rng(42);  // Deterministic: before/after runs must compare
+  std::normal_distribution<double> jitter(0.0, hrvMs);
+  std::normal_distribution<double> noise(0.0, noiseRms);
+
+  double meanIbiMs = 60000.0 / bpm;
+  double totalMs = seconds * 1000.0;
+
+  // Beat onset times with IBI jitter
+  std::vector<double> onsets;
+  double t = 200.0;
+  while (t < totalMs) {
+    onsets.push_back(t);
+    double ibi = meanIbiMs + jitter(rng);
+    if (ibi < meanIbiMs * 0.5) {
+      ibi = meanIbiMs * 0.5;
+    }
+    t += ibi;
+  }
+
+  double intervalMs = 1000.0 / rateHz;
+  size_t count = (size_t)(totalMs / intervalMs);
+  size_t nextOnset = 0;
+  for (size_t n = 0; n < count; n++) {
+    double tm = n * intervalMs;
+    while (nextOnset < onsets.size() && onsets[nextOnset] <= tm) {
+      nextOnset++;
+    }
+
+    double v = 2048.0;
+    // Sum contributions from the surrounding beats
+    for (size_t b = (nextOnset >= 2) ? nextOnset - 2 : 0;
+         b < onsets.size() && b <= nextOnset; b++) {
+      double dt = tm - onsets[b];
+      if (dt < 0 || dt > meanIbiMs) {
+        continue;
+      }
+      v += 1100.0 * exp(-(dt - 120.0) * (dt - 120.0) / (2.0 * 45.0 * 45.0));
+      v += 280.0 * exp(-(dt - 320.0) * (dt - 320.0) / (2.0 * 70.0 * 70.0));
+    }
+    v += noise(rng);
+
+    if (v < 0) v = 0;
+    if (v > 4095) v = 4095;
+    samples->push_back((uint16_t)v);
+  }
+
+  for (double onset : onsets) {
+    truth->push_back({onset});
+  }
+}
+
+// ============================================================================
+// Replay and reporting
+// ============================================================================
+
+static int cmpDouble(const void* a, const void* b) {
+  double d = *(const double*)a - *(const double*)b;
+  return (d > 0) - (d < 0);
+}
+
+int main(int argc, char** argv) {
+  const char* tracePath = nullptr;
+  double synthSeconds = 0;
+  double bpm = 72.0;
+  double hrvMs = 0.0;
+  double noiseRms = 0.0;
+  int decimate = 1;
+  bool useFilter = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (strcmp(argv[i], "--synth") == 0 && i + 1 < argc) {
+      synthSeconds = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--bpm") == 0 && i + 1 < argc) {
+      bpm = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--hrv") == 0 && i + 1 < argc) {
+      hrvMs = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc) {
+      noiseRms = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--decimate") == 0 && i + 1 < argc) {
+      decimate = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--filter") == 0) {
+      useFilter = true;
+    } else {
+      fprintf(stderr,
+              "Usage: %s (--trace FILE | --synth SECS) [--bpm N] [--hrv MS]\n"
+              "          [--noise RMS] [--decimate FACTOR] [--filter]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if ((tracePath == nullptr) == (synthSeconds <= 0)) {
+    fprintf(stderr, "Exactly one of --trace or --synth is required\n");
+    return 1;
+  }
+  if (decimate < 1) {
+    fprintf(stderr, "--decimate must be >= 1\n");
+    return 1;
+  }
+
+  // Input samples are at the capture rate: the wire rate for traces and
+  // plain synthesis, or wire rate x factor when benching the decimator.
+  int captureRateHz = WIRE_RATE_HZ * decimate;
+  std::vector<uint16_t> input;
+  std::vector<TruthBeat> truth;
+
+  if (tracePath) {
+    if (decimate > 1) {
+      fprintf(stderr, "--decimate applies to --synth only (traces are 50Hz)\n");
+      return 1;
+    }
+    if (!loadTrace(tracePath, &input)) {
+      return 1;
+    }
+  } else {
+    synthesize(synthSeconds, bpm, hrvMs, noiseRms, captureRateHz, &input,
+               &truth);
+    printf("Synth: %.0fs at %dHz, %.0f BPM, hrv=%.0fms, noise=%.0f RMS\n",
+           synthSeconds, captureRateHz, bpm, hrvMs, noiseRms);
+  }
+
+  // Replay through (optional) decimator + detector, timing the whole
+  // kernel chain exactly as the firmware runs it
+  BeatDetector detector(WIRE_INTERVAL_MS);
+  Decimator decimator(decimate);
+  PpgFilter filter(WIRE_RATE_HZ);  // conditioning runs at the wire rate
+  std::vector<double> beatTimes;
+
+  auto start = std::chrono::steady_clock::now();
+  uint32_t wireIndex = 0;
+  for (size_t n = 0; n < input.size(); n++) {
+    uint16_t wireSample;
+    if (decimate > 1) {
+      if (!decimator.processSample(input[n], &wireSample)) {
+        continue;
+      }
+    } else {
+      wireSample = input[n];
+    }
+    if (useFilter) {
+      wireSample = filter.processSample(wireSample);
+    }
+    if (detector.processSample(wireSample)) {
+      beatTimes.push_back((double)wireIndex * WIRE_INTERVAL_MS);
+    }
+    wireIndex++;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double totalNs =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
+  double nsPerSample = totalNs / input.size();
+
+  printf("\nCost (%zu input samples, decimate=%d):\n", input.size(), decimate);
+  printf("  %.1f ns/sample, %.2f Msamples/s on this host\n", nsPerSample,
+         1000.0 / nsPerSample);
+  printf("  at 240MHz that is roughly %.1f us/sample (assuming a 3GHz host)\n",
+         nsPerSample * 1e-3 * 3.0e9 / 240e6);
+
+  printf("\nDetection:\n");
+  printf("  beats detected: %zu\n", beatTimes.size());
+
+  if (truth.empty()) {
+    return 0;
+  }
+
+  // Match each truth beat to the nearest detection within half the mean
+  // IBI; unmatched detections are false positives.
+  double meanIbiMs = 60000.0 / bpm;
+  double window = meanIbiMs / 2.0;
+  size_t matched = 0;
+  std::vector<char> used(beatTimes.size(), 0);
+  std::vector<double> latencies;
+  std::vector<double> matchedTimes;  // detection times of matched beats
+
+  for (const TruthBeat& tb : truth) {
+    double best = window;
+    int bestIdx = -1;
+    for (size_t d = 0; d < beatTimes.size(); d++) {
+      if (used[d]) {
+        continue;
+      }
+      double diff = beatTimes[d] - tb.timeMs;
+      if (diff >= 0 && diff < best) {
+        best = diff;
+        bestIdx = (int)d;
+      }
+    }
+    if (bestIdx >= 0) {
+      used[bestIdx] = 1;
+      matched++;
+      latencies.push_back(best);
+      matchedTimes.push_back(beatTimes[bestIdx]);
+    }
+  }
+  size_t falsePositives = beatTimes.size() - matched;
+
+  printf("  ground truth:   %zu\n", truth.size());
+  printf("  matched:        %zu (%.1f%%), false positives: %zu\n", matched,
+         100.0 * matched / truth.size(), falsePositives);
+
+  // IBI error: consecutive matched detections vs the truth IBIs they span.
+  // This is the number the downstream BPM/prediction pipeline cares about.
+  std::vector<double> ibiErrors;
+  for (size_t i = 1; i < matchedTimes.size(); i++) {
+    double detIbi = matchedTimes[i] - matchedTimes[i - 1];
+    double truthIbi = latencies.size() == matchedTimes.size()
+                          ? (matchedTimes[i] - latencies[i]) -
+                                (matchedTimes[i - 1] - latencies[i - 1])
+                          : meanIbiMs;
+    ibiErrors.push_back(detIbi - truthIbi);
+  }
+
+  if (!ibiErrors.empty()) {
+    double sum = 0, sumSq = 0;
+    for (double e : ibiErrors) {
+      sum += e;
+      sumSq += e * e;
+    }
+    double mean = sum / ibiErrors.size();
+    double stddev = sqrt(sumSq / ibiErrors.size() - mean * mean);
+
+    std::vector<double> sorted = ibiErrors;
+    for (double& e : sorted) {
+      e = fabs(e);
+    }
+    qsort(sorted.data(), sorted.size(), sizeof(double), cmpDouble);
+    double p50 = sorted[sorted.size() / 2];
+    double p95 = sorted[(size_t)(sorted.size() * 0.95)];
+    double worst = sorted.back();
+
+    printf("\nIBI error vs truth (%zu intervals):\n", ibiErrors.size());
+    printf("  mean %+.1fms, stddev %.1fms\n", mean, stddev);
+    printf("  |error| p50 %.1fms, p95 %.1fms, max %.1fms\n", p50, p95, worst);
+  }
+
+  if (!latencies.empty()) {
+    double sum = 0;
+    for (double l : latencies) {
+      sum += l;
+    }
+    printf("\nDetection latency after pulse onset: mean %.0fms\n",
+           sum / latencies.size());
+  }
+
+  return 0;
+}
@@ -0,0 +1,404 @@
+/*
+ * Amor server - native PPG ingest and beat-detection daemon
+ *
+ * Drop-in alternative to the hot path of amor/processor.py for large
+ * installations: receives the /ppg/N UDP stream on PORT_PPG, parses both
+ * bundle formats the firmware emits, runs the shared BeatDetector (the
+ * port of PulseSensor::processLatestSample, compiled from the firmware
+ * tree) per channel, and broadcasts /beat/N messages on PORT_BEATS in the
+ * same shape the Python processor emits:
+ *
+ *   /beat/{ppg_id}  [timestamp_ms (int32), bpm (float32), intensity (float32)]
+ *
+ * The socket is opened with SO_REUSEPORT so it coexists with the Python
+ * processor and viewers on the broadcast bus (see amor/osc.py), and beats
+ * go out with SO_BROADCAST so every listener on PORT_BEATS receives them.
+ *
+ * Units running ENABLE_SEQ_RETRANSMIT stamp each bundle with a sequence
+ * number (version-2 blob header). The daemon tracks the per-channel seq
+ * cursor, books gaps as loss, and NACKs the missing seqs back to the
+ * sending unit's admin port for selective resend; holes that come back
+ * are booked as recovered. The running loss rate doubles as a per-unit
+ * link-quality metric in the stats line. Bundles without a seq are
+ * ingested exactly as before.
+ *
+ * The daemon is also the server-side clock-sync responder: units built
+ * with ENABLE_CLOCK_SYNC ping /sync/ping [ppg_id, seq, t1_ms] at
+ * SYNC_PORT and get /sync/pong [seq, t1_ms, server_ms] straight back
+ * (see firmware/amor/src/clock_sync.h), so their bundle timestamps
+ * arrive in server time.
+ *
+ * Throughput: a bundle is ~40 bytes and arrives at 10Hz per sensor, so a
+ * hundred sensors is ~1000 small datagrams/s — a single select loop over
+ * the two sockets handles that with most of a core to spare.
+ *
+ * Usage:
+ *   amor-ingestd [--port 8000] [--beats-port 8001] [--beats-host 255.255.255.255]
+ *                [--admin-port 8006] [--sync-port 8007] [--rate 50]
+ *                [--no-nack] [--verbose]
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <beat_detector.h>
+#include "osc_codec.h"
+
+// Matches amor/osc.py: PORT_PPG, PORT_BEATS, PORT_ADMIN
+#define DEFAULT_PPG_PORT 8000
+#define DEFAULT_BEATS_PORT 8001
+#define DEFAULT_BEATS_HOST "255.255.255.255"
+#define DEFAULT_ADMIN_PORT 8006
+#define DEFAULT_SYNC_PORT 8007  // firmware SYNC_PORT (clock_sync.h)
+#define DEFAULT_SAMPLE_RATE_HZ 50
+
+// At most this many seqs per NACK datagram. The firmware history ring
+// keeps 64 bundles (RETRANSMIT_HISTORY_BUNDLES); gaps wider than that
+// have already aged out on the unit, so chasing them is pointless — they
+// are booked as lost and the cursor resyncs.
+#define NACK_MAX_SEQS 32
+
+// A seq this far behind the cursor isn't a late retransmit, it's a unit
+// whose counter restarted (reflash, RTC loss): resync instead of
+// recording a bogus recovery.
+#define SEQ_RESYNC_THRESHOLD 256
+
+// Channel ids are small integers (firmware PPG_ID); allow headroom well
+// past the "dozens of sensors" target.
+#define MAX_CHANNELS 256
+
+// Stats line interval, matching the firmware's 5s cadence
+#define STATS_INTERVAL_MS 5000
+
+struct Channel {
+  bool active = false;
+  BeatDetector detector;
+  uint32_t bundles = 0;
+  uint32_t samples = 0;
+  uint32_t beats = 0;
+  int lastBpm = 0;
+  // Sequence accounting (units running ENABLE_SEQ_RETRANSMIT only)
+  bool seqValid = false;
+  uint32_t nextSeq = 0;      // Seq we expect next on this channel
+  uint32_t lost = 0;         // Gap bundles never seen (net of recoveries)
+  uint32_t recovered = 0;    // Holes filled by a late/resent bundle
+  uint32_t nacksSent = 0;
+};
+
+static Channel channels[MAX_CHANNELS];
+
+static int64_t nowMs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr,
+          "Usage: %s [--port N] [--beats-port N] [--beats-host ADDR] "
+          "[--admin-port N] [--sync-port N] [--rate HZ] [--no-nack] "
+          "[--verbose]\n",
+          prog);
+}
+
+int main(int argc, char** argv) {
+  int ppgPort = DEFAULT_PPG_PORT;
+  int beatsPort = DEFAULT_BEATS_PORT;
+  const char* beatsHost = DEFAULT_BEATS_HOST;
+  int adminPort = DEFAULT_ADMIN_PORT;
+  int syncPort = DEFAULT_SYNC_PORT;
+  int sampleRateHz = DEFAULT_SAMPLE_RATE_HZ;
+  bool nackEnabled = true;
+  bool verbose = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+      ppgPort = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--beats-port") == 0 && i + 1 < argc) {
+      beatsPort = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--beats-host") == 0 && i + 1 < argc) {
+      beatsHost = argv[++i];
+    } else if (strcmp(argv[i], "--admin-port") == 0 && i + 1 < argc) {
+      adminPort = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--sync-port") == 0 && i + 1 < argc) {
+      syncPort = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+      sampleRateHz = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--no-nack") == 0) {
+      nackEnabled = false;
+    } else if (strcmp(argv[i], "--verbose") == 0) {
+      verbose = true;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (ppgPort <= 0 || beatsPort <= 0 || adminPort <= 0 || syncPort <= 0 ||
+      sampleRateHz <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+  int sampleIntervalMs = 1000 / sampleRateHz;
+
+  // Receive socket: SO_REUSEPORT so the Python processor and viewers can
+  // share PORT_PPG on the same host (broadcast bus architecture)
+  int rx = socket(AF_INET, SOCK_DGRAM, 0);
+  if (rx < 0) {
+    perror("socket");
+    return 1;
+  }
+  int one = 1;
+  setsockopt(rx, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+  setsockopt(rx, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+
+  struct sockaddr_in bindAddr;
+  memset(&bindAddr, 0, sizeof(bindAddr));
+  bindAddr.sin_family = AF_INET;
+  bindAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+  bindAddr.sin_port = htons((uint16_t)ppgPort);
+  if (bind(rx, (struct sockaddr*)&bindAddr, sizeof(bindAddr)) < 0) {
+    perror("bind");
+    return 1;
+  }
+
+  // Sync responder socket: units ping here and the pong goes straight
+  // back to the ping's source (the unit's bound admin socket)
+  int sync = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sync < 0) {
+    perror("socket");
+    return 1;
+  }
+  setsockopt(sync, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+  setsockopt(sync, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+  bindAddr.sin_port = htons((uint16_t)syncPort);
+  if (bind(sync, (struct sockaddr*)&bindAddr, sizeof(bindAddr)) < 0) {
+    perror("bind");
+    return 1;
+  }
+
+  // Beats socket: broadcast so all SO_REUSEPORT listeners on PORT_BEATS
+  // (audio, lighting, viewer) receive each beat
+  int tx = socket(AF_INET, SOCK_DGRAM, 0);
+  if (tx < 0) {
+    perror("socket");
+    return 1;
+  }
+  setsockopt(tx, SOL_SOCKET, SO_BROADCAST, &one, sizeof(one));
+
+  struct sockaddr_in beatsAddr;
+  memset(&beatsAddr, 0, sizeof(beatsAddr));
+  beatsAddr.sin_family = AF_INET;
+  beatsAddr.sin_port = htons((uint16_t)beatsPort);
+  if (inet_pton(AF_INET, beatsHost, &beatsAddr.sin_addr) != 1) {
+    fprintf(stderr, "Invalid --beats-host: %s\n", beatsHost);
+    return 1;
+  }
+
+  printf("amor-ingestd: /ppg on :%d, /sync on :%d -> /beat to %s:%d "
+         "(rate %dHz)\n",
+         ppgPort, syncPort, beatsHost, beatsPort, sampleRateHz);
+
+  uint8_t packet[1500];
+  uint8_t beatMsg[64];
+  uint8_t nackMsg[256];
+  uint8_t pongMsg[64];
+  uint64_t totalPackets = 0;
+  uint64_t badPackets = 0;
+  uint64_t pongsSent = 0;
+  int64_t lastStatsMs = nowMs();
+
+  for (;;) {
+    fd_set readFds;
+    FD_ZERO(&readFds);
+    FD_SET(rx, &readFds);
+    FD_SET(sync, &readFds);
+    int maxFd = (rx > sync ? rx : sync) + 1;
+    if (select(maxFd, &readFds, nullptr, nullptr, nullptr) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("select");
+      return 1;
+    }
+
+    // Clock-sync exchange: echo seq and t1 with our clock, immediately —
+    // responder latency lands in the unit's RTT estimate
+    if (FD_ISSET(sync, &readFds)) {
+      struct sockaddr_in pingAddr;
+      socklen_t pingLen = sizeof(pingAddr);
+      ssize_t pn = recvfrom(sync, packet, sizeof(packet), 0,
+                            (struct sockaddr*)&pingAddr, &pingLen);
+      int32_t pingId, pingSeq;
+      uint32_t t1Ms;
+      if (pn > 0 &&
+          oscParseSyncPing(packet, (size_t)pn, &pingId, &pingSeq, &t1Ms)) {
+        size_t len = oscBuildSyncPong(pongMsg, sizeof(pongMsg), pingSeq,
+                                      t1Ms, (uint32_t)nowMs());
+        if (len > 0) {
+          sendto(sync, pongMsg, len, 0, (struct sockaddr*)&pingAddr,
+                 pingLen);
+          pongsSent++;
+          if (verbose) {
+            printf("SYNC: PPG %d, seq %d\n", pingId, pingSeq);
+          }
+        }
+      }
+    }
+
+    if (!FD_ISSET(rx, &readFds)) {
+      continue;
+    }
+
+    // Source address is kept so NACKs can go back to the sending unit
+    struct sockaddr_in srcAddr;
+    socklen_t srcLen = sizeof(srcAddr);
+    ssize_t n = recvfrom(rx, packet, sizeof(packet), 0,
+                         (struct sockaddr*)&srcAddr, &srcLen);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("recvfrom");
+      return 1;
+    }
+    totalPackets++;
+
+    PpgBundle bundle;
+    if (!oscParsePpg(packet, (size_t)n, &bundle) ||
+        bundle.ppgId >= MAX_CHANNELS) {
+      badPackets++;
+      continue;
+    }
+
+    Channel& ch = channels[bundle.ppgId];
+    if (!ch.active) {
+      ch.active = true;
+      ch.detector = BeatDetector(sampleIntervalMs);
+      printf("Channel %d: first bundle (%d samples, ts=%u)\n", bundle.ppgId,
+             bundle.count, bundle.timestampMs);
+    }
+    ch.bundles++;
+
+    // Sequence accounting: distinguish loss from reordering and chase
+    // recent holes with a NACK to the unit's admin port
+    bool lateBundle = false;
+    if (bundle.hasSeq) {
+      if (!ch.seqValid) {
+        ch.seqValid = true;
+        ch.nextSeq = bundle.seq + 1;
+      } else if (bundle.seq == ch.nextSeq) {
+        ch.nextSeq++;
+      } else if ((int32_t)(bundle.seq - ch.nextSeq) > 0) {
+        uint32_t gap = bundle.seq - ch.nextSeq;
+        ch.lost += gap;
+        if (nackEnabled && gap <= NACK_MAX_SEQS) {
+          uint32_t seqs[NACK_MAX_SEQS];
+          int count = 0;
+          for (uint32_t s = ch.nextSeq; s != bundle.seq; s++) {
+            seqs[count++] = s;
+          }
+          size_t len = oscBuildNack(nackMsg, sizeof(nackMsg), seqs, count);
+          if (len > 0) {
+            struct sockaddr_in nackAddr = srcAddr;
+            nackAddr.sin_port = htons((uint16_t)adminPort);
+            sendto(tx, nackMsg, len, 0, (struct sockaddr*)&nackAddr,
+                   sizeof(nackAddr));
+            ch.nacksSent += (uint32_t)count;
+          }
+        }
+        // Wider gaps have aged out of the unit's history ring: booked as
+        // lost, cursor resyncs
+        ch.nextSeq = bundle.seq + 1;
+      } else if (ch.nextSeq - bundle.seq > SEQ_RESYNC_THRESHOLD) {
+        // Counter restarted on the unit (reflash, RTC loss): start over
+        ch.nextSeq = bundle.seq + 1;
+      } else {
+        // Behind the cursor: a retransmit (or reorder) filled a hole.
+        // Its samples are out of order now, so they stay away from the
+        // beat detector — the recovery only benefits archival consumers
+        // and the loss accounting.
+        ch.recovered++;
+        if (ch.lost > 0) {
+          ch.lost--;
+        }
+        lateBundle = true;
+      }
+    }
+    if (lateBundle) {
+      continue;
+    }
+
+    for (int i = 0; i < bundle.count; i++) {
+      ch.samples++;
+      if (!ch.detector.processSample(bundle.samples[i])) {
+        continue;
+      }
+
+      // Beat timestamp is wall-clock Unix ms, as the Python processor
+      // sends; intensity maps the pulse amplitude onto the 0..1 range
+      // the downstream consumers expect from the predictor's confidence.
+      int64_t beatTs = nowMs();
+      float bpm = (float)ch.detector.getBeatsPerMinute();
+      float intensity = (float)ch.detector.getPulseAmplitude() / 4095.0f;
+      if (intensity > 1.0f) {
+        intensity = 1.0f;
+      }
+
+      size_t len = oscBuildBeat(beatMsg, sizeof(beatMsg), bundle.ppgId,
+                                (int32_t)beatTs, bpm, intensity);
+      if (len > 0) {
+        sendto(tx, beatMsg, len, 0, (struct sockaddr*)&beatsAddr,
+               sizeof(beatsAddr));
+      }
+
+      ch.beats++;
+      ch.lastBpm = ch.detector.getBeatsPerMinute();
+      if (verbose) {
+        printf("BEAT: PPG %d, BPM: %d, IBI: %dms\n", bundle.ppgId,
+               ch.lastBpm, ch.detector.getInterBeatIntervalMs());
+      }
+    }
+
+    // Periodic one-line stats, same register as the firmware's printStats()
+    int64_t now = nowMs();
+    if (now - lastStatsMs >= STATS_INTERVAL_MS) {
+      lastStatsMs = now;
+      printf("[ingestd] packets=%llu bad=%llu |",
+             (unsigned long long)totalPackets, (unsigned long long)badPackets);
+      if (pongsSent > 0) {
+        printf(" sync pongs=%llu |", (unsigned long long)pongsSent);
+      }
+      for (int id = 0; id < MAX_CHANNELS; id++) {
+        if (channels[id].active) {
+          printf(" ch%d: %u bundles, %u beats (%d BPM)", id,
+                 channels[id].bundles, channels[id].beats,
+                 channels[id].lastBpm);
+          if (channels[id].seqValid) {
+            // Link quality: bundles lost for good vs recovered via NACK
+            double lossPct = 100.0 * channels[id].lost /
+                             (channels[id].bundles + channels[id].lost);
+            printf(" loss %u (%.2f%%), %u recovered, %u nacked",
+                   channels[id].lost, lossPct, channels[id].recovered,
+                   channels[id].nacksSent);
+          }
+        }
+      }
+      printf("\n");
+      fflush(stdout);
+    }
+  }
+}
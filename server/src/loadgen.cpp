@@ -0,0 +1,389 @@
+/*
+ * Amor server - OSC load generator for sizing large installations
+ *
+ * amor/simulator/ppg_emulator.py covers functional testing, but Python
+ * tops out well below the packet rates a 50-sensor deployment produces.
+ * This tool emits the exact /ppg/N datagrams sendPPGBundle() puts on the
+ * wire — classic or packed, with or without sequence numbers — for a
+ * configurable fleet of simulated units, each with its own pulse
+ * waveform, send jitter, deliberate loss and clock skew, at thousands of
+ * packets per second from one machine. Point it at amor-ingestd (or the
+ * Python processor) and watch the ingest stats for the ceiling.
+ *
+ * The receiver mode closes the loop on the same host: it parses the /ppg
+ * stream, measures delivery latency against the embedded timestamps
+ * (relative to the smallest offset seen, so clock offset cancels out) and
+ * counts sequence gaps, giving transit percentiles and loss under load.
+ *
+ * Usage:
+ *   amor-loadgen [--units 4] [--rate 50] [--bundle 5] [--bpm 72]
+ *                [--host 127.0.0.1] [--port 8000] [--duration 10]
+ *                [--packed] [--seq] [--jitter MS] [--loss PCT] [--skew PPM]
+ *   amor-loadgen --receive [--port 8000] [--duration 10]
+ *
+ * Example (find the ingest ceiling for a 50-unit build-out):
+ *   amor-loadgen --units 50 --packed --seq --jitter 20 --loss 1 --duration 60
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "osc_codec.h"
+
+#define DEFAULT_PPG_PORT 8000
+#define MAX_UNITS 256
+
+static int64_t nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// ============================================================================
+// Simulated unit
+// ============================================================================
+
+// One fleet member: its own pulse train (the detect_bench waveform shape),
+// bundle clock with per-send jitter, deliberate loss, and a skewed local
+// millis() for the embedded timestamps.
+struct Unit {
+  int ppgId;
+  std::mt19937 rng;
+  double skew;            // Local clock rate ratio (1.0 = perfect)
+  double nextOnsetMs;     // Next pulse onset, unit-local time
+  double prevOnsetMs;
+  double meanIbiMs;
+  int64_t nextSendUs;     // Real time of the next bundle
+  uint32_t bundleIndex;   // Bundles sent (drives the sample grid)
+  uint32_t seq;
+};
+
+// Gaussian systolic peak plus a dicrotic bump, same shape detect_bench
+// synthesizes, evaluated at one unit-local instant.
+static uint16_t sampleWaveform(Unit& u, double localMs,
+                               std::normal_distribution<double>& noise) {
+  while (localMs >= u.nextOnsetMs) {
+    u.prevOnsetMs = u.nextOnsetMs;
+    u.nextOnsetMs += u.meanIbiMs;
+  }
+  double v = 2048.0;
+  for (double onset : {u.prevOnsetMs, u.nextOnsetMs - 2 * u.meanIbiMs}) {
+    double dt = localMs - onset;
+    if (dt < 0 || dt > u.meanIbiMs) {
+      continue;
+    }
+    v += 1100.0 * exp(-(dt - 120.0) * (dt - 120.0) / (2.0 * 45.0 * 45.0));
+    v += 280.0 * exp(-(dt - 320.0) * (dt - 320.0) / (2.0 * 70.0 * 70.0));
+  }
+  v += noise(u.rng);
+  if (v < 0) v = 0;
+  if (v > 4095) v = 4095;
+  return (uint16_t)v;
+}
+
+// ============================================================================
+// Receiver mode
+// ============================================================================
+
+static int runReceiver(int port, double durationSecs) {
+  int rx = socket(AF_INET, SOCK_DGRAM, 0);
+  if (rx < 0) {
+    perror("socket");
+    return 1;
+  }
+  int one = 1;
+  setsockopt(rx, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+  setsockopt(rx, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+  struct timeval tv = {1, 0};
+  setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  struct sockaddr_in bindAddr;
+  memset(&bindAddr, 0, sizeof(bindAddr));
+  bindAddr.sin_family = AF_INET;
+  bindAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+  bindAddr.sin_port = htons((uint16_t)port);
+  if (bind(rx, (struct sockaddr*)&bindAddr, sizeof(bindAddr)) < 0) {
+    perror("bind");
+    return 1;
+  }
+
+  printf("Receiving /ppg on :%d for %.0fs...\n", port, durationSecs);
+
+  uint8_t packet[1500];
+  uint64_t packets = 0, bad = 0, bytes = 0, lost = 0;
+  bool seqValid[MAX_UNITS] = {};
+  uint32_t nextSeq[MAX_UNITS] = {};
+  std::vector<float> latencies;
+  double minOffsetMs = 1e18;
+
+  int64_t start = nowUs();
+  int64_t deadline = start + (int64_t)(durationSecs * 1e6);
+  int64_t lastLine = start;
+  uint64_t lastPackets = 0;
+
+  while (nowUs() < deadline) {
+    ssize_t n = recv(rx, packet, sizeof(packet), 0);
+    int64_t arrivalUs = nowUs();
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        continue;
+      }
+      perror("recv");
+      return 1;
+    }
+
+    PpgBundle bundle;
+    if (!oscParsePpg(packet, (size_t)n, &bundle)) {
+      bad++;
+      continue;
+    }
+    packets++;
+    bytes += (uint64_t)n;
+
+    // Transit time relative to the smallest (arrival - embedded ts) seen:
+    // the sender's clock offset cancels, leaving queueing/scheduling delay
+    double offsetMs = arrivalUs / 1000.0 - (double)bundle.timestampMs;
+    if (offsetMs < minOffsetMs) {
+      minOffsetMs = offsetMs;
+    }
+    latencies.push_back((float)(offsetMs - minOffsetMs));
+
+    if (bundle.hasSeq && bundle.ppgId < MAX_UNITS) {
+      int id = bundle.ppgId;
+      if (!seqValid[id]) {
+        seqValid[id] = true;
+      } else if ((int32_t)(bundle.seq - nextSeq[id]) > 0) {
+        lost += bundle.seq - nextSeq[id];
+      }
+      nextSeq[id] = bundle.seq + 1;
+    }
+
+    if (arrivalUs - lastLine >= 1000000) {
+      printf("  %8.1f pps  %6.2f Mbit/s  lost %llu\n",
+             (packets - lastPackets) * 1e6 / (arrivalUs - lastLine),
+             bytes * 8.0 / (arrivalUs - start), (unsigned long long)lost);
+      lastLine = arrivalUs;
+      lastPackets = packets;
+    }
+  }
+
+  double elapsed = (nowUs() - start) / 1e6;
+  printf("\nReceived %llu bundles (%llu bad) in %.1fs: %.0f pps, %.2f Mbit/s\n",
+         (unsigned long long)packets, (unsigned long long)bad, elapsed,
+         packets / elapsed, bytes * 8.0 / elapsed / 1e6);
+  if (lost > 0) {
+    printf("Sequence gaps: %llu bundles (%.2f%%)\n", (unsigned long long)lost,
+           100.0 * lost / (packets + lost));
+  }
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    printf("Transit latency (vs best seen): p50 %.2fms, p95 %.2fms, "
+           "p99 %.2fms, max %.2fms\n",
+           latencies[latencies.size() / 2],
+           latencies[(size_t)(latencies.size() * 0.95)],
+           latencies[(size_t)(latencies.size() * 0.99)], latencies.back());
+  }
+  return 0;
+}
+
+// ============================================================================
+// Sender mode
+// ============================================================================
+
+int main(int argc, char** argv) {
+  int units = 4;
+  int rateHz = 50;
+  int bundleSize = 5;
+  double bpm = 72.0;
+  const char* host = "127.0.0.1";
+  int port = DEFAULT_PPG_PORT;
+  double durationSecs = 10.0;
+  bool packed = false;
+  bool withSeq = false;
+  double jitterMs = 0.0;
+  double lossPct = 0.0;
+  double skewPpm = 0.0;
+  bool receive = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--units") == 0 && i + 1 < argc) {
+      units = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+      rateHz = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--bundle") == 0 && i + 1 < argc) {
+      bundleSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--bpm") == 0 && i + 1 < argc) {
+      bpm = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+      host = argv[++i];
+    } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+      port = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      durationSecs = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--packed") == 0) {
+      packed = true;
+    } else if (strcmp(argv[i], "--seq") == 0) {
+      withSeq = true;
+    } else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+      jitterMs = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc) {
+      lossPct = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--skew") == 0 && i + 1 < argc) {
+      skewPpm = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--receive") == 0) {
+      receive = true;
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--units N] [--rate HZ] [--bundle N] [--bpm N]\n"
+              "          [--host ADDR] [--port N] [--duration SECS]\n"
+              "          [--packed] [--seq] [--jitter MS] [--loss PCT]\n"
+              "          [--skew PPM]\n"
+              "       %s --receive [--port N] [--duration SECS]\n",
+              argv[0], argv[0]);
+      return 1;
+    }
+  }
+  if (receive) {
+    return runReceiver(port, durationSecs);
+  }
+  if (units < 1 || units > MAX_UNITS || rateHz < 1 || bundleSize < 1 ||
+      bundleSize > OSC_CODEC_MAX_SAMPLES || durationSecs <= 0) {
+    fprintf(stderr, "Out-of-range parameter\n");
+    return 1;
+  }
+  if (withSeq && !packed) {
+    fprintf(stderr, "--seq requires --packed (as on the firmware)\n");
+    return 1;
+  }
+
+  int tx = socket(AF_INET, SOCK_DGRAM, 0);
+  if (tx < 0) {
+    perror("socket");
+    return 1;
+  }
+  struct sockaddr_in dest;
+  memset(&dest, 0, sizeof(dest));
+  dest.sin_family = AF_INET;
+  dest.sin_port = htons((uint16_t)port);
+  if (inet_pton(AF_INET, host, &dest.sin_addr) != 1) {
+    fprintf(stderr, "Invalid --host: %s\n", host);
+    return 1;
+  }
+
+  double bundleIntervalUs = 1e6 * bundleSize / rateHz;
+  double sampleIntervalMs = 1000.0 / rateHz;
+  double pps = units * 1e6 / bundleIntervalUs;
+  printf("Fleet: %d units, %dHz x %d-sample bundles -> %.0f pps to %s:%d "
+         "(%s%s, jitter %.0fms, loss %.1f%%, skew %.0fppm) for %.0fs\n",
+         units, rateHz, bundleSize, pps, host, port,
+         packed ? "packed" : "classic", withSeq ? "+seq" : "", jitterMs,
+         lossPct, skewPpm, durationSecs);
+
+  int64_t start = nowUs();
+  std::vector<Unit> fleet((size_t)units);
+  std::uniform_real_distribution<double> skewDist(-skewPpm, skewPpm);
+  for (int i = 0; i < units; i++) {
+    Unit& u = fleet[i];
+    u.ppgId = i;
+    u.rng.seed(42 + (uint32_t)i);  // Deterministic per unit
+    u.skew = 1.0 + skewDist(u.rng) * 1e-6;
+    u.meanIbiMs = 60000.0 / bpm * (0.9 + 0.2 * (i % 7) / 6.0);  // Spread BPMs
+    u.prevOnsetMs = 0;
+    u.nextOnsetMs = 200.0 + i * 37.0;  // Decorrelate beat phases
+    // Stagger first sends across one interval so bundles don't burst
+    u.nextSendUs = start + (int64_t)(bundleIntervalUs * i / units);
+    u.bundleIndex = 0;
+    u.seq = 0;
+  }
+
+  std::normal_distribution<double> noise(0.0, 30.0);
+  std::normal_distribution<double> jitter(0.0, jitterMs * 1000.0);
+  std::uniform_real_distribution<double> drop(0.0, 100.0);
+
+  uint8_t datagram[512];
+  uint16_t samples[OSC_CODEC_MAX_SAMPLES];
+  uint64_t sent = 0, dropped = 0, bytes = 0;
+  int64_t deadline = start + (int64_t)(durationSecs * 1e6);
+  int64_t lastLine = start;
+  uint64_t lastSent = 0;
+
+  for (;;) {
+    // Next due unit (linear scan: even 256 units is nothing at these rates)
+    Unit* due = &fleet[0];
+    for (auto& u : fleet) {
+      if (u.nextSendUs < due->nextSendUs) {
+        due = &u;
+      }
+    }
+    if (due->nextSendUs >= deadline) {
+      break;
+    }
+    int64_t wait = due->nextSendUs - nowUs();
+    if (wait > 0) {
+      usleep((useconds_t)wait);
+    }
+
+    // Unit-local timestamp of the bundle's first sample, with clock skew
+    double gridMs =
+        (double)due->bundleIndex * bundleSize * sampleIntervalMs;
+    uint32_t timestampMs = (uint32_t)(gridMs * due->skew);
+    for (int s = 0; s < bundleSize; s++) {
+      samples[s] = sampleWaveform(*due, gridMs + s * sampleIntervalMs, noise);
+    }
+
+    uint32_t seq = due->seq;
+    size_t len = oscBuildPpg(datagram, sizeof(datagram), due->ppgId, samples,
+                             bundleSize, timestampMs, packed,
+                             withSeq ? &seq : nullptr);
+    if (withSeq) {
+      due->seq++;
+    }
+
+    // Deliberate loss: seq still advances, so a seq-aware receiver (or
+    // ingestd's NACK path) sees a real gap
+    if (lossPct > 0 && drop(due->rng) < lossPct) {
+      dropped++;
+    } else if (len > 0) {
+      sendto(tx, datagram, len, 0, (struct sockaddr*)&dest, sizeof(dest));
+      sent++;
+      bytes += len;
+    }
+
+    due->bundleIndex++;
+    due->nextSendUs = start +
+                      (int64_t)((double)due->bundleIndex * bundleIntervalUs +
+                                bundleIntervalUs * due->ppgId / units +
+                                jitter(due->rng));
+
+    int64_t now = nowUs();
+    if (now - lastLine >= 1000000) {
+      printf("  %8.1f pps  (%llu sent, %llu dropped)\n",
+             (sent - lastSent) * 1e6 / (now - lastLine),
+             (unsigned long long)sent, (unsigned long long)dropped);
+      lastLine = now;
+      lastSent = sent;
+    }
+  }
+
+  double elapsed = (nowUs() - start) / 1e6;
+  printf("\nSent %llu bundles (%llu deliberately dropped) in %.1fs: "
+         "%.0f pps, %.2f Mbit/s\n",
+         (unsigned long long)sent, (unsigned long long)dropped, elapsed,
+         sent / elapsed, bytes * 8.0 / elapsed / 1e6);
+  return 0;
+}
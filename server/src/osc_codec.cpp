@@ -0,0 +1,242 @@
+#include <cstdio>
+#include <cstring>
+#include "osc_codec.h"
+#include "wire.h"
+
+// OSC pads strings and blobs to 4-byte boundaries.
+static size_t pad4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+static uint32_t getUint32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void putUint32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)(v & 0xFF);
+}
+
+bool oscParsePpg(const uint8_t* buf, size_t len, PpgBundle* out) {
+  if (len < 8) {
+    return false;
+  }
+
+  // Address: "/ppg/" followed by a small decimal id, NUL-padded
+  if (memcmp(buf, "/ppg/", 5) != 0) {
+    return false;
+  }
+  size_t addrEnd = 5;
+  int id = 0;
+  while (addrEnd < len && buf[addrEnd] >= '0' && buf[addrEnd] <= '9') {
+    id = id * 10 + (buf[addrEnd] - '0');
+    addrEnd++;
+  }
+  if (addrEnd == 5 || addrEnd >= len || buf[addrEnd] != '\0') {
+    return false;
+  }
+
+  size_t pos = pad4(addrEnd + 1);
+  if (pos + 4 > len || buf[pos] != ',') {
+    return false;
+  }
+
+  // Type tags, NUL-terminated within the datagram
+  const char* tags = (const char*)(buf + pos + 1);
+  size_t tagsMax = len - pos - 1;
+  size_t tagsLen = strnlen(tags, tagsMax);
+  if (tagsLen == tagsMax) {
+    return false;
+  }
+  size_t argsPos = pos + pad4(1 + tagsLen + 1);
+
+  if (tagsLen == 1 && tags[0] == 'b') {
+    // Packed bundle: one blob in the project wire format
+    if (argsPos + 4 > len) {
+      return false;
+    }
+    uint32_t blobLen = getUint32(buf + argsPos);
+    if (argsPos + 4 + blobLen > len) {
+      return false;
+    }
+    int count = ppgWireUnpack(buf + argsPos + 4, blobLen, out->samples,
+                              OSC_CODEC_MAX_SAMPLES, &out->timestampMs,
+                              &out->seq);
+    if (count <= 0) {
+      return false;
+    }
+    out->hasSeq = (buf[argsPos + 4] == PPG_WIRE_VERSION_SEQ);
+    out->ppgId = id;
+    out->count = count;
+    return true;
+  }
+
+  // Classic bundle: all-int32 tags, samples then timestamp
+  if (tagsLen < 2 || tagsLen > OSC_CODEC_MAX_SAMPLES + 1) {
+    return false;
+  }
+  for (size_t i = 0; i < tagsLen; i++) {
+    if (tags[i] != 'i') {
+      return false;
+    }
+  }
+  if (argsPos + tagsLen * 4 > len) {
+    return false;
+  }
+
+  int count = (int)tagsLen - 1;
+  for (int i = 0; i < count; i++) {
+    uint32_t v = getUint32(buf + argsPos + (size_t)i * 4);
+    if (v > 4095) {
+      return false;  // 12-bit ADC range, same check the Python processor does
+    }
+    out->samples[i] = (uint16_t)v;
+  }
+  out->timestampMs = getUint32(buf + argsPos + (size_t)count * 4);
+  out->ppgId = id;
+  out->count = count;
+  out->hasSeq = false;
+  out->seq = 0;
+  return true;
+}
+
+size_t oscBuildPpg(uint8_t* out, size_t cap, int ppgId,
+                   const uint16_t* samples, int count, uint32_t timestampMs,
+                   bool packed, const uint32_t* seq) {
+  if (count < 1 || count > OSC_CODEC_MAX_SAMPLES) {
+    return 0;
+  }
+
+  char address[16];
+  int addrLen = snprintf(address, sizeof(address), "/ppg/%d", ppgId);
+  size_t addrPadded = pad4((size_t)addrLen + 1);
+
+  size_t need;
+  size_t blobLen = 0;
+  if (packed) {
+    blobLen = seq ? (size_t)PPG_WIRE_BLOB_SIZE_SEQ(count)
+                  : (size_t)PPG_WIRE_BLOB_SIZE(count);
+    need = addrPadded + pad4(2 + 1) + 4 + pad4(blobLen);
+  } else {
+    // "," + count 'i' tags + 'i' for the timestamp + NUL, padded
+    need = addrPadded + pad4(1 + (size_t)count + 1 + 1) +
+           ((size_t)count + 1) * 4;
+  }
+  if (cap < need) {
+    return 0;
+  }
+
+  memset(out, 0, need);
+  uint8_t* p = out;
+  memcpy(p, address, (size_t)addrLen);
+  p += addrPadded;
+
+  if (packed) {
+    p[0] = ',';
+    p[1] = 'b';
+    p += pad4(2 + 1);
+    putUint32(p, (uint32_t)blobLen);
+    p += 4;
+    if (seq) {
+      ppgWirePackSeq(p, samples, (uint16_t)count, timestampMs, *seq);
+    } else {
+      ppgWirePack(p, samples, (uint16_t)count, timestampMs);
+    }
+  } else {
+    p[0] = ',';
+    for (int i = 0; i < count + 1; i++) {
+      p[1 + i] = 'i';
+    }
+    p += pad4(1 + (size_t)count + 1 + 1);
+    for (int i = 0; i < count; i++) {
+      putUint32(p + (size_t)i * 4, samples[i]);
+    }
+    putUint32(p + (size_t)count * 4, timestampMs);
+  }
+
+  return need;
+}
+
+size_t oscBuildBeat(uint8_t* out, size_t cap, int ppgId, int32_t timestampMs,
+                    float bpm, float intensity) {
+  char address[16];
+  int addrLen = snprintf(address, sizeof(address), "/beat/%d", ppgId);
+  size_t need = pad4((size_t)addrLen + 1) + pad4(1 + 3 + 1) + 12;
+  if (cap < need) {
+    return 0;
+  }
+
+  memset(out, 0, need);
+  uint8_t* p = out;
+  memcpy(p, address, (size_t)addrLen);
+  p += pad4((size_t)addrLen + 1);
+  memcpy(p, ",iff", 4);
+  p += pad4(1 + 3 + 1);
+
+  putUint32(p, (uint32_t)timestampMs);
+  uint32_t bits;
+  memcpy(&bits, &bpm, 4);
+  putUint32(p + 4, bits);
+  memcpy(&bits, &intensity, 4);
+  putUint32(p + 8, bits);
+
+  return need;
+}
+
+bool oscParseSyncPing(const uint8_t* buf, size_t len, int32_t* ppgId,
+                      int32_t* seq, uint32_t* t1Ms) {
+  // "/sync/ping" NUL-padded to 12, ",iii" NUL-padded to 8, three int32s
+  if (len < 12 + 8 + 12 || memcmp(buf, "/sync/ping\0", 12) != 0 ||
+      memcmp(buf + 12, ",iii\0", 5) != 0) {
+    return false;
+  }
+  *ppgId = (int32_t)getUint32(buf + 20);
+  *seq = (int32_t)getUint32(buf + 24);
+  *t1Ms = getUint32(buf + 28);
+  return true;
+}
+
+size_t oscBuildSyncPong(uint8_t* out, size_t cap, int32_t seq, uint32_t t1Ms,
+                        uint32_t serverMs) {
+  // "/sync/pong" NUL-padded to 12, ",iii" NUL-padded to 8, three int32s
+  size_t need = 12 + 8 + 12;
+  if (cap < need) {
+    return 0;
+  }
+  memset(out, 0, need);
+  memcpy(out, "/sync/pong", 10);
+  memcpy(out + 12, ",iii", 4);
+  putUint32(out + 20, (uint32_t)seq);
+  putUint32(out + 24, t1Ms);
+  putUint32(out + 28, serverMs);
+  return need;
+}
+
+size_t oscBuildNack(uint8_t* out, size_t cap, const uint32_t* seqs,
+                    int count) {
+  if (count < 1 || count > 60) {  // keep the datagram comfortably small
+    return 0;
+  }
+  // "/nack" padded + "," + count 'i' tags + NUL padded + count int32 args
+  size_t tagsLen = pad4(1 + (size_t)count + 1);
+  size_t need = pad4(5 + 1) + tagsLen + (size_t)count * 4;
+  if (cap < need) {
+    return 0;
+  }
+
+  memset(out, 0, need);
+  uint8_t* p = out;
+  memcpy(p, "/nack", 5);
+  p += pad4(5 + 1);
+  p[0] = ',';
+  for (int i = 0; i < count; i++) {
+    p[1 + i] = 'i';
+  }
+  p += tagsLen;
+  for (int i = 0; i < count; i++) {
+    putUint32(p + (size_t)i * 4, seqs[i]);
+  }
+
+  return need;
+}
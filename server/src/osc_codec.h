@@ -0,0 +1,65 @@
+/*
+ * Amor server - minimal OSC codec for the PPG bus
+ *
+ * Just enough OSC to speak the project's wire formats without pulling in a
+ * library: parse the /ppg/N bundles the firmware emits (classic int32-per-
+ * sample and packed 12-bit blob, see firmware/amor/src/osc_out.cpp) and
+ * build the /beat/N messages amor/processor.py broadcasts on PORT_BEATS
+ * ([timestamp_ms (int32), bpm (float32), intensity (float32)]).
+ */
+
+#ifndef OSC_CODEC_H
+#define OSC_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Upper bound on samples per bundle we accept; the firmware default is 5.
+#define OSC_CODEC_MAX_SAMPLES 64
+
+struct PpgBundle {
+  int ppgId;
+  int count;
+  uint16_t samples[OSC_CODEC_MAX_SAMPLES];
+  uint32_t timestampMs;   // Device (or server, with clock sync) time of the
+                          // first sample in the bundle
+  bool hasSeq;            // True for version-2 blobs (ENABLE_SEQ_RETRANSMIT
+                          // firmware); classic and v1 bundles carry no seq
+  uint32_t seq;           // Transmit sequence number when hasSeq
+};
+
+// Parse one /ppg/N datagram. Returns false for anything that isn't a
+// well-formed PPG bundle (wrong address, tags, truncation, bad blob).
+bool oscParsePpg(const uint8_t* buf, size_t len, PpgBundle* out);
+
+// Render a /ppg/N bundle byte-identical to what the firmware emits:
+// classic all-int32 ([samples..., timestamp]) when packed is false, or
+// the packed blob (version 1, or version 2 with the sequence number when
+// seq is non-NULL). Returns the datagram length, or 0 if cap is too
+// small or count is out of range. Used by the load generator.
+size_t oscBuildPpg(uint8_t* out, size_t cap, int ppgId,
+                   const uint16_t* samples, int count, uint32_t timestampMs,
+                   bool packed, const uint32_t* seq);
+
+// Render a /beat/N message into out (capacity cap). Returns the datagram
+// length, or 0 if cap is too small.
+size_t oscBuildBeat(uint8_t* out, size_t cap, int ppgId, int32_t timestampMs,
+                    float bpm, float intensity);
+
+// Render a /nack message ([seq...], one int32 per missing sequence number)
+// for the firmware's admin channel. Returns the datagram length, or 0 if
+// cap is too small or count is out of range.
+size_t oscBuildNack(uint8_t* out, size_t cap, const uint32_t* seqs, int count);
+
+// Parse one /sync/ping from a unit's clock-sync engine ([ppg_id, seq,
+// t1_ms], see firmware/amor/src/clock_sync.h). Returns false for anything
+// else.
+bool oscParseSyncPing(const uint8_t* buf, size_t len, int32_t* ppgId,
+                      int32_t* seq, uint32_t* t1Ms);
+
+// Render the /sync/pong reply ([seq, t1_ms, server_ms]). Returns the
+// datagram length, or 0 if cap is too small.
+size_t oscBuildSyncPong(uint8_t* out, size_t cap, int32_t seq, uint32_t t1Ms,
+                        uint32_t serverMs);
+
+#endif // OSC_CODEC_H
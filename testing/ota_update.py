@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+OTA Update Sender - streams a firmware image to an ESP32 unit over OSC.
+
+Counterpart to ENABLE_OTA_UPDATE in the firmware (src/ota_update.h):
+sends /ota/begin with the image size and MD5, then the image in
+/ota/data [index, blob] chunks, waiting for the per-chunk /ota/ack
+before sending the next (lost datagrams are retried), and finishes with
+/ota/end. The unit verifies the MD5, switches app slots and reboots.
+
+Usage:
+    python3 testing/ota_update.py <unit_ip> <firmware.bin> [--port 8006]
+"""
+
+import argparse
+import hashlib
+import socket
+import struct
+import sys
+import time
+
+CHUNK_SIZE = 384        # Must fit the firmware's OTA_CHUNK_MAX (400)
+ACK_TIMEOUT = 2.0       # Seconds to wait for an ack before retrying
+MAX_RETRIES = 5         # Per-chunk retries before giving up
+
+
+def osc_message(address, *args):
+    """Build a minimal OSC message; args may be int or bytes (blob)."""
+    def pad4(b):
+        return b + b'\x00' * ((4 - len(b) % 4) % 4)
+
+    msg = pad4(address.encode() + b'\x00')
+    tags = ','
+    payload = b''
+    for arg in args:
+        if isinstance(arg, int):
+            tags += 'i'
+            payload += struct.pack('>i', arg)
+        elif isinstance(arg, bytes):
+            tags += 'b'
+            payload += struct.pack('>i', len(arg)) + pad4(arg)
+        elif isinstance(arg, str):
+            tags += 's'
+            payload += pad4(arg.encode() + b'\x00')
+        else:
+            raise TypeError(f"unsupported OSC arg type: {type(arg)}")
+    return msg + pad4(tags.encode() + b'\x00') + payload
+
+
+def wait_for(sock, addresses):
+    """Block until a datagram starting with one of the addresses arrives.
+    Returns (address, raw_datagram) or (None, None) on timeout."""
+    try:
+        data, _ = sock.recvfrom(512)
+    except socket.timeout:
+        return None, None
+    for address in addresses:
+        if data.startswith(address.encode() + b'\x00'):
+            return address, data
+    return None, data
+
+
+def ack_index(data):
+    """Extract the acked chunk index from an /ota/ack datagram, or None.
+
+    Layout: "/ota/ack" NUL-padded to 12, ",i" NUL-padded to 4, int32."""
+    try:
+        return struct.unpack_from('>i', data, 16)[0]
+    except struct.error:
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('unit_ip', help='IP address of the ESP32 unit')
+    parser.add_argument('image', help='firmware.bin to send')
+    parser.add_argument('--port', type=int, default=8006,
+                        help='admin port (default 8006)')
+    args = parser.parse_args()
+
+    with open(args.image, 'rb') as f:
+        image = f.read()
+    md5 = hashlib.md5(image).hexdigest()
+    chunks = [image[i:i + CHUNK_SIZE] for i in range(0, len(image), CHUNK_SIZE)]
+
+    print(f"Image: {len(image)} bytes, {len(chunks)} chunks, MD5 {md5}")
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(ACK_TIMEOUT)
+    dest = (args.unit_ip, args.port)
+
+    # Enter receive mode
+    for attempt in range(MAX_RETRIES):
+        sock.sendto(osc_message('/ota/begin', len(image), md5), dest)
+        address, _ = wait_for(sock, ['/ota/ready', '/ota/error'])
+        if address == '/ota/ready':
+            break
+        if address == '/ota/error':
+            sys.exit("Unit rejected /ota/begin (partition too small? "
+                     "ENABLE_OTA_UPDATE not built in?)")
+    else:
+        sys.exit("No response to /ota/begin — unit unreachable or admin "
+                 "channel disabled")
+
+    # Stream chunks, one in flight, retrying on a lost datagram or ack
+    start = time.monotonic()
+    for index, chunk in enumerate(chunks):
+        for attempt in range(MAX_RETRIES):
+            sock.sendto(osc_message('/ota/data', index, chunk), dest)
+            # Only the ack carrying the in-flight index advances the
+            # window: a late ack that raced a retry names the previous
+            # chunk, and treating it as this chunk's would desequence
+            # the stream and abort the transfer on the unit
+            acked = False
+            deadline = time.monotonic() + ACK_TIMEOUT
+            while not acked:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    break
+                sock.settimeout(remaining)
+                address, data = wait_for(sock, ['/ota/ack', '/ota/error'])
+                if address == '/ota/error':
+                    sys.exit(f"Unit aborted at chunk {index} — check its "
+                             "serial output, then rerun")
+                if address == '/ota/ack':
+                    acked = ack_index(data) == index  # stale acks discarded
+                elif data is None:
+                    break  # timeout: resend this chunk
+            if acked:
+                break
+        else:
+            sys.exit(f"Chunk {index} unacked after {MAX_RETRIES} tries")
+        if index % 256 == 0 or index == len(chunks) - 1:
+            pct = 100 * (index + 1) // len(chunks)
+            rate = (index + 1) * CHUNK_SIZE / (time.monotonic() - start) / 1024
+            print(f"\r{pct:3d}%  ({rate:.0f} KB/s)", end='', flush=True)
+    print()
+
+    # Finalize: MD5 check, slot switch, reboot
+    sock.settimeout(ACK_TIMEOUT)
+    sock.sendto(osc_message('/ota/end'), dest)
+    address, _ = wait_for(sock, ['/ota/ok', '/ota/error'])
+    if address != '/ota/ok':
+        sys.exit("Verification failed — image discarded, unit unchanged")
+
+    elapsed = time.monotonic() - start
+    print(f"Update verified in {elapsed:.0f}s; unit is rebooting into the "
+          "new image")
+
+
+if __name__ == '__main__':
+    main()